@@ -0,0 +1,476 @@
+/**
+ * aos_bench - Microbenchmarks for the hot paths of A-OS
+ *
+ * Runs offscreen (headless software renderer) so results don't depend on
+ * a display or vsync. Each benchmark is warmed up, then timed over a
+ * number of samples; every sample runs enough operations to take about
+ * SAMPLE_TIME_MS. Reported per operation:
+ *   - time (median, mean, min, max and stddev over the samples)
+ *   - Renderer draw calls, texture creations and text rasterizations
+ *   - heap allocations (operator new calls on the benchmark thread)
+ *
+ * Usage: aos_bench [--filter TEXT] [--samples N] [--json FILE]
+ * The JSON file is meant for comparing two builds.
+ *
+ * aos_bench --check-allocations instead verifies that steady-state input
+ * and voice events never touch the heap, and exits non-zero if they do.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "os/os_core.h"
+#include "os/coroutine.h"
+#include "os/event_bus.h"
+#include "apps/home_app.h"
+#include "apps/settings_app.h"
+#include "apps/camera_app.h"
+#include "apps/sysinfo_app.h"
+#include "apps/media_app.h"
+#include "apps/flappy_app.h"
+
+#ifndef AOS_BUILD_TYPE
+#define AOS_BUILD_TYPE "unknown"
+#endif
+
+// Apps reach the AppManager through this (defined by main.cpp in the OS)
+AOS::AppManager* g_appManager = nullptr;
+
+#ifdef AOS_COROUTINES
+// A per-frame animation as an app would write it
+static AOS::Task animateEveryFrame(volatile uint64_t* steps) {
+    for (;;) {
+        co_await AOS::nextFrame();
+        *steps = *steps + 1;
+    }
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+// Per thread, so SDL's audio thread doesn't pollute the numbers
+static thread_local uint64_t t_allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    t_allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int WIDTH = 1280;
+constexpr int HEIGHT = 720;
+constexpr int DEFAULT_SAMPLES = 20;
+constexpr double WARMUP_TIME_MS = 100.0;
+constexpr double SAMPLE_TIME_MS = 10.0;
+
+/**
+ * One benchmark: op() is a single operation. finish() (optional) runs at
+ * the end of every sample inside the timed region, e.g. to submit queued
+ * primitives so their cost is counted.
+ */
+struct Benchmark {
+    std::string name;
+    std::function<void()> op;
+    std::function<void()> finish;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t opsPerSample;
+    int samples;
+    double medianNs;
+    double meanNs;
+    double minNs;
+    double maxNs;
+    double stddevNs;
+    double drawCallsPerOp;
+    double texturesPerOp;
+    double textRastersPerOp;
+    double allocationsPerOp;
+};
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+class BenchRunner {
+public:
+    BenchRunner(AOS::Renderer& benchRenderer, int sampleCount)
+        : renderer(benchRenderer)
+        , samples(sampleCount)
+    {
+    }
+
+    BenchResult run(const Benchmark& bench) {
+        // Warm up caches and measure roughly how fast one op is
+        uint64_t warmupOps = 0;
+        Clock::time_point warmupStart = Clock::now();
+        while (elapsedMs(warmupStart) < WARMUP_TIME_MS) {
+            bench.op();
+            if (bench.finish) {
+                bench.finish();
+            }
+            warmupOps++;
+        }
+        double msPerOp = elapsedMs(warmupStart) / (double)warmupOps;
+        uint64_t opsPerSample = std::max<uint64_t>(1, (uint64_t)(SAMPLE_TIME_MS / msPerOp));
+
+        std::vector<double> nsPerOp;
+        nsPerOp.reserve(samples);
+
+        renderer.resetCounters();
+        uint64_t allocationsBefore = t_allocationCount;
+
+        for (int s = 0; s < samples; ++s) {
+            Clock::time_point start = Clock::now();
+            for (uint64_t i = 0; i < opsPerSample; ++i) {
+                bench.op();
+            }
+            if (bench.finish) {
+                bench.finish();
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            nsPerOp.push_back(ns / (double)opsPerSample);
+        }
+
+        uint64_t allocations = t_allocationCount - allocationsBefore;
+        AOS::RenderCounters counters = renderer.getCounters();
+        const double totalOps = (double)opsPerSample * samples;
+
+        BenchResult result = {};
+        result.name = bench.name;
+        result.opsPerSample = opsPerSample;
+        result.samples = samples;
+
+        std::vector<double> sorted = nsPerOp;
+        std::sort(sorted.begin(), sorted.end());
+        result.medianNs = sorted.size() % 2 ? sorted[sorted.size() / 2]
+                        : 0.5 * (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]);
+        result.minNs = sorted.front();
+        result.maxNs = sorted.back();
+
+        double sum = 0.0;
+        for (double ns : nsPerOp) {
+            sum += ns;
+        }
+        result.meanNs = sum / nsPerOp.size();
+
+        double variance = 0.0;
+        for (double ns : nsPerOp) {
+            variance += (ns - result.meanNs) * (ns - result.meanNs);
+        }
+        result.stddevNs = nsPerOp.size() > 1 ? std::sqrt(variance / (nsPerOp.size() - 1)) : 0.0;
+
+        result.drawCallsPerOp = counters.drawCalls / totalOps;
+        result.texturesPerOp = counters.textureCreations / totalOps;
+        result.textRastersPerOp = counters.textRasterizations / totalOps;
+        result.allocationsPerOp = allocations / totalOps;
+        return result;
+    }
+
+private:
+    AOS::Renderer& renderer;
+    int samples;
+};
+
+void printResult(const BenchResult& r) {
+    std::cout << std::left << std::setw(36) << r.name << std::right << std::fixed
+              << std::setprecision(1)
+              << std::setw(12) << r.medianNs
+              << std::setw(9) << (r.meanNs > 0.0 ? 100.0 * r.stddevNs / r.meanNs : 0.0) << "%"
+              << std::setprecision(2)
+              << std::setw(10) << r.drawCallsPerOp
+              << std::setw(10) << r.texturesPerOp
+              << std::setw(10) << r.allocationsPerOp << std::endl;
+}
+
+// Names are plain ASCII identifiers, no escaping needed
+bool writeJson(const std::string& path, const std::vector<BenchResult>& results, int samples) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"context\": {\"build_type\": \"" << AOS_BUILD_TYPE << "\", \"renderer\": \"software\""
+        << ", \"width\": " << WIDTH << ", \"height\": " << HEIGHT << ", \"samples\": " << samples
+        << "},\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\"name\": \"" << r.name << "\""
+            << ", \"ops_per_sample\": " << r.opsPerSample
+            << ", \"samples\": " << r.samples
+            << ", \"ns_per_op\": {\"median\": " << r.medianNs << ", \"mean\": " << r.meanNs
+            << ", \"min\": " << r.minNs << ", \"max\": " << r.maxNs << ", \"stddev\": " << r.stddevNs << "}"
+            << ", \"draw_calls_per_op\": " << r.drawCallsPerOp
+            << ", \"textures_per_op\": " << r.texturesPerOp
+            << ", \"text_rasters_per_op\": " << r.textRastersPerOp
+            << ", \"allocations_per_op\": " << r.allocationsPerOp << "}";
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+// Publish and dispatch a frame's worth of key presses and voice partials,
+// many times over, and count heap allocations once warmed up
+bool checkEventAllocations(AOS::EventBus& eventBus) {
+    constexpr int WARMUP_FRAMES = 100;
+    constexpr int CHECKED_FRAMES = 10000;
+    static const char* const VOICE_PARTIALS[] = {
+        "turn on",
+        "turn on the living room",
+        "turn on the living room lights and set them to fifty percent brightness"
+    };
+
+    uint64_t voiceBytes = 0;
+    AOS::EventBus::Subscription subscription = eventBus.subscribe(
+        AOS::EventType::VOICE_PARTIAL,
+        [&voiceBytes](const AOS::Event& event) { voiceBytes += event.payload.size(); });
+
+    auto runFrame = [&eventBus](int frame) {
+        eventBus.publish(AOS::Event(AOS::EventType::KEY_DOWN));
+        eventBus.publish(AOS::Event(AOS::EventType::KEY_SELECT));
+        for (int i = 0; i < 3; ++i) {
+            eventBus.publish(AOS::Event(AOS::EventType::VOICE_PARTIAL, VOICE_PARTIALS[i], frame));
+        }
+        eventBus.processEvents();
+    };
+
+    for (int frame = 0; frame < WARMUP_FRAMES; ++frame) {
+        runFrame(frame);
+    }
+
+    uint64_t allocationsBefore = t_allocationCount;
+    for (int frame = 0; frame < CHECKED_FRAMES; ++frame) {
+        runFrame(frame);
+    }
+    uint64_t allocations = t_allocationCount - allocationsBefore;
+
+    eventBus.unsubscribe(subscription);
+
+    std::cout << "Event allocation check: " << CHECKED_FRAMES * 5 << " events ("
+              << voiceBytes << " payload bytes dispatched), " << allocations << " heap allocations: "
+              << (allocations == 0 ? "PASS" : "FAIL") << std::endl;
+    return allocations == 0;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --filter TEXT   Only run benchmarks whose name contains TEXT\n"
+              << "  --samples N     Timed samples per benchmark (default " << DEFAULT_SAMPLES << ")\n"
+              << "  --json FILE     Also write the results to FILE as JSON\n"
+              << "  --check-allocations  Fail if steady-state events allocate\n"
+              << "  --help          Show this message" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string jsonPath;
+    int samples = DEFAULT_SAMPLES;
+    bool checkAllocations = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(arg, "--samples") == 0 && hasValue) {
+            samples = std::max(2, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(arg, "--check-allocations") == 0) {
+            checkAllocations = true;
+        } else {
+            if (std::strcmp(arg, "--help") != 0) {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            }
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    AOS::LaunchOptions options;
+    options.width = WIDTH;
+    options.height = HEIGHT;
+    options.headless = true;
+
+    AOS::OSCore os;
+    if (!os.initialize(options)) {
+        std::cerr << "Failed to initialize A-OS" << std::endl;
+        return 1;
+    }
+
+    AOS::Renderer& renderer = os.getRenderer();
+    AOS::AppManager& appManager = os.getAppManager();
+    AOS::EventBus& eventBus = AOS::EventBus::getInstance();
+
+    // Before any app runs, so key events stop at the AppManager
+    if (checkAllocations) {
+        bool passed = checkEventAllocations(eventBus);
+        os.shutdown();
+        return passed ? 0 : 1;
+    }
+
+    // Same app set as the OS, so the home screen has its real tile count
+    g_appManager = &appManager;
+    appManager.registerApp<AOS::HomeApp>();
+    appManager.registerApp<AOS::SettingsApp>();
+    appManager.registerApp<AOS::CameraApp>();
+    appManager.registerApp<AOS::SysInfoApp>();
+    appManager.registerApp<AOS::MediaApp>();
+    appManager.registerApp<AOS::FlappyApp>();
+    appManager.launchApp(0);
+
+    // Labels that change every op, like a clock or counter would
+    std::vector<std::string> varyingLabels;
+    for (int i = 0; i < 1000; ++i) {
+        varyingLabels.push_back("Uptime 00:" + std::to_string(10 + i % 50) + ":" + std::to_string(i));
+    }
+    size_t labelIndex = 0;
+    const std::vector<std::string> menuLabels = {
+        "Display", "Sound", "Network", "Bluetooth", "Storage", "Battery", "Updates", "About"
+    };
+    uint64_t navigateFrame = 0;
+
+    volatile uint64_t eventsHandled = 0;
+    eventBus.subscribe(AOS::EventType::CUSTOM, [&eventsHandled](const AOS::Event&) { eventsHandled = eventsHandled + 1; });
+    for (int i = 0; i < 8; ++i) {
+        eventBus.subscribe(AOS::EventType::VOICE_PARTIAL, [&eventsHandled](const AOS::Event&) { eventsHandled = eventsHandled + 1; });
+    }
+
+    const AOS::Color white = AOS::Color::White();
+    auto flush = [&renderer]() { renderer.flush(); };
+
+    // Static text is drawn once per frame, as in an app, so the frame
+    // index moves between samples
+    auto endFrame = [&renderer]() {
+        renderer.flush();
+        renderer.present();
+    };
+
+    std::vector<Benchmark> benchmarks = {
+        { "renderer.drawText.static",
+          [&]() { renderer.drawText("Settings", 100, 100, white, 24); }, endFrame },
+        // One frame of a menu: the labels share a size, so they share a glyph atlas texture
+        { "renderer.drawText.menu",
+          [&]() {
+              for (size_t i = 0; i < menuLabels.size(); ++i) {
+                  renderer.drawText(menuLabels[i], 100, 200 + 30 * (int)i, white, 24);
+              }
+              endFrame();
+          }, nullptr },
+        { "renderer.drawText.varying",
+          [&]() {
+              renderer.drawText(varyingLabels[labelIndex], 100, 140, white, 24);
+              labelIndex = (labelIndex + 1) % varyingLabels.size();
+          }, flush },
+        { "renderer.drawCircle.filled",
+          [&]() { renderer.drawCircle(300, 300, 40, AOS::Color(80, 160, 240)); }, flush },
+        { "renderer.drawCircle.outline",
+          [&]() { renderer.drawCircle(400, 300, 40, AOS::Color(80, 160, 240), false); }, flush },
+        { "renderer.drawRoundedRect",
+          [&]() { renderer.drawRoundedRect(AOS::Rect(80, 400, 500, 100), AOS::Color(40, 40, 60), 12); }, flush },
+        { "renderer.drawShadow",
+          [&]() { renderer.drawShadow(AOS::Rect(80, 400, 500, 100), 4, 8); }, flush },
+        { "eventbus.publish_process",
+          [&]() {
+              eventBus.publish(AOS::Event(AOS::EventType::CUSTOM, "", 1));
+              eventBus.processEvents();
+          }, nullptr },
+        { "eventbus.publish_process.fanout8",
+          [&]() {
+              eventBus.publish(AOS::Event(AOS::EventType::VOICE_PARTIAL, "turn on the living room lights", 1));
+              eventBus.processEvents();
+          }, nullptr },
+        { "eventbus.publish64_process",
+          [&]() {
+              for (int i = 0; i < 64; ++i) {
+                  eventBus.publish(AOS::Event(AOS::EventType::CUSTOM, "", i));
+              }
+              eventBus.processEvents();
+          }, nullptr },
+        { "app.home.frame",
+          [&]() {
+              appManager.update(1.0f / 60.0f);
+              renderer.clear(AOS::Color::Black());
+              appManager.render(renderer);
+              renderer.present();
+          }, nullptr },
+        // Focus moves every 8 frames, so tile layers keep re-rendering their labels
+        { "app.home.frame.navigate",
+          [&]() {
+              if (navigateFrame++ % 8 == 0) {
+                  const bool down = (navigateFrame / 8) % 2 == 0;
+                  eventBus.publish(AOS::Event(down ? AOS::EventType::KEY_DOWN : AOS::EventType::KEY_UP));
+                  eventBus.processEvents();
+              }
+              appManager.update(1.0f / 60.0f);
+              renderer.clear(AOS::Color::Black());
+              appManager.render(renderer);
+              renderer.present();
+          }, nullptr },
+    };
+
+#ifdef AOS_COROUTINES
+    // 16 coroutines resumed per frame; their frames come from the pool
+    volatile uint64_t animationSteps = 0;
+    std::vector<AOS::Task> animations;
+    for (int i = 0; i < 16; ++i) {
+        animations.push_back(animateEveryFrame(&animationSteps));
+    }
+    benchmarks.push_back({ "coroutine.resume_frame16",
+                           []() { AOS::CoroutineScheduler::getInstance().resumeFrame(); }, nullptr });
+#endif
+
+    std::cout << std::left << std::setw(36) << "benchmark" << std::right
+              << std::setw(12) << "ns/op" << std::setw(10) << "+/-"
+              << std::setw(10) << "calls/op" << std::setw(10) << "tex/op"
+              << std::setw(10) << "allocs/op" << std::endl;
+
+    BenchRunner runner(renderer, samples);
+    std::vector<BenchResult> results;
+    for (const Benchmark& bench : benchmarks) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(runner.run(bench));
+        printResult(results.back());
+    }
+
+    bool ok = jsonPath.empty() || writeJson(jsonPath, results, samples);
+
+    g_appManager = nullptr;
+    os.shutdown();
+    return ok ? 0 : 1;
+}
@@ -1,7 +1,10 @@
 #include "camera_app.h"
 #include "os/app_manager.h"
+#include "os/job_system.h"
+#include "os/timer_service.h"
 #include <iostream>
 #include <cmath>
+#include <memory>
 
 extern AOS::AppManager* g_appManager;
 
@@ -11,9 +14,11 @@ CameraApp::CameraApp()
     : currentMode(PREVIEW)
     , previewTime(0.0f)
     , capturing(false)
-    , captureFlashTime(0.0f)
+    , captureFlashStart(0)
+    , flashTimer()
     , photoCount(0)
     , galleryIndex(0)
+    , session(0)
 {
 }
 
@@ -21,13 +26,20 @@ void CameraApp::onStart() {
     std::cout << "CameraApp: Started" << std::endl;
     previewTime = 0.0f;
     capturing = false;
-    captureFlashTime = 0.0f;
     currentMode = PREVIEW;
 }
 
+void CameraApp::onPause() {
+    TimerService::getInstance().cancel(flashTimer);
+    capturing = false;
+}
+
 void CameraApp::onStop() {
     std::cout << "CameraApp: Stopped" << std::endl;
 
+    // Photos still being processed are dropped when they arrive
+    session++;
+
     // Free all captured photos
     for (auto& photo : photos) {
         if (photo.surface) {
@@ -37,17 +49,19 @@ void CameraApp::onStop() {
     photos.clear();
 }
 
+size_t CameraApp::getMemoryFootprint() const {
+    size_t bytes = 0;
+    for (const auto& photo : photos) {
+        if (photo.surface) {
+            bytes += (size_t)photo.surface->pitch * photo.surface->h;
+        }
+    }
+    return bytes;
+}
+
 void CameraApp::update(float deltaTime) {
     if (currentMode == PREVIEW) {
         previewTime += deltaTime;
-
-        if (capturing) {
-            captureFlashTime += deltaTime;
-            if (captureFlashTime > 0.3f) {
-                capturing = false;
-                captureFlashTime = 0.0f;
-            }
-        }
     }
 }
 
@@ -103,7 +117,8 @@ void CameraApp::render(Renderer& renderer) {
 
         // Capture flash effect
         if (capturing) {
-            int alpha = (int)((1.0f - captureFlashTime / 0.3f) * 200);
+            uint64_t flashElapsed = TimerService::getInstance().getNow() - captureFlashStart;
+            int alpha = (int)((1.0f - (float)flashElapsed / FLASH_DURATION_MS) * 200);
             renderer.drawRect(
                 Rect(0, 0, renderer.getWidth(), renderer.getHeight()),
                 Color(255, 255, 255, alpha),
@@ -194,23 +209,29 @@ void CameraApp::onEvent(const Event& event) {
     } else if (currentMode == PREVIEW) {
         if (event.type == EventType::KEY_SELECT) {
             // Capture photo
+            TimerService& timers = TimerService::getInstance();
             capturing = true;
-            captureFlashTime = 0.0f;
+            captureFlashStart = timers.getNow();
+            timers.cancel(flashTimer);
+            flashTimer = timers.schedule(FLASH_DURATION_MS, [this]() { capturing = false; });
             photoCount++;
             std::cout << "CameraApp: Photo captured (#" << photoCount << ")" << std::endl;
 
-            // Create a simulated photo with a unique color pattern
-            SDL_Surface* surface = SDL_CreateRGBSurface(0, 600, 400, 32, 0, 0, 0, 0);
-            if (surface) {
-                // Fill with a gradient based on photo number
-                SDL_FillRect(surface, nullptr,
-                    SDL_MapRGB(surface->format,
-                               40 + (photoCount * 30) % 180,
-                               60 + (photoCount * 45) % 180,
-                               40 + (photoCount * 60) % 180));
-
-                photos.push_back({surface, photoCount});
-            }
+            // Process the photo on a worker; it joins the gallery when done
+            auto photo = std::make_shared<Photo>(Photo{nullptr, photoCount});
+            const uint32_t captureSession = session;
+            JobSystem::getInstance().submit(
+                [photo]() { photo->surface = createPhotoSurface(photo->number); },
+                [this, photo, captureSession]() {
+                    if (!photo->surface) {
+                        return;
+                    }
+                    if (captureSession != session) {
+                        SDL_FreeSurface(photo->surface);
+                        return;
+                    }
+                    photos.push_back(*photo);
+                });
         } else if (event.type == EventType::KEY_UP) {
             // Switch to gallery
             switchToGallery();
@@ -244,6 +265,20 @@ void CameraApp::switchToPreview() {
     std::cout << "CameraApp: Switched to preview mode" << std::endl;
 }
 
+SDL_Surface* CameraApp::createPhotoSurface(int number) {
+    // Create a simulated photo with a unique color pattern
+    SDL_Surface* surface = SDL_CreateRGBSurface(0, 600, 400, 32, 0, 0, 0, 0);
+    if (surface) {
+        // Fill with a gradient based on photo number
+        SDL_FillRect(surface, nullptr,
+            SDL_MapRGB(surface->format,
+                       40 + (number * 30) % 180,
+                       60 + (number * 45) % 180,
+                       40 + (number * 60) % 180));
+    }
+    return surface;
+}
+
 void CameraApp::capturePhoto(SDL_Renderer* sdlRenderer) {
     // This would capture actual screenshot in production
     // For now, we create a simulated photo in onEvent
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "os/app.h"
+#include "os/timer_service.h"
 #include "ui/renderer.h"
 #include <vector>
 #include <SDL2/SDL.h>
@@ -26,12 +27,17 @@ public:
     ~CameraApp() override = default;
 
     void onStart() override;
+    void onPause() override;
     void onStop() override;
     void update(float deltaTime) override;
     void render(Renderer& renderer) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "Camera"; }
+    // The captured photos, kept while suspended
+    size_t getMemoryFootprint() const override;
+
+    static constexpr const char* NAME = "Camera";
+    std::string getName() const override { return NAME; }
 
 private:
     enum Mode {
@@ -46,13 +52,20 @@ private:
 
     Mode currentMode;
     float previewTime;
+    static constexpr uint32_t FLASH_DURATION_MS = 300;
+
     bool capturing;
-    float captureFlashTime;
+    uint64_t captureFlashStart;   // TimerService clock (ms)
+    TimerService::TimerHandle flashTimer;
     int photoCount;
     std::vector<Photo> photos;
     int galleryIndex;
+    uint32_t session;             // Bumped on stop; stale photo jobs are discarded
 
     void capturePhoto(SDL_Renderer* sdlRenderer);
+
+    // Runs on a worker thread (software surfaces only)
+    static SDL_Surface* createPhotoSurface(int number);
     void switchToGallery();
     void switchToPreview();
 };
@@ -16,6 +16,8 @@ FlappyApp::FlappyApp()
     , gapDistribution(150, 500)
     , gameTime(0.0f)
     , groundOffset(0.0f)
+    , previousGroundOffset(0.0f)
+    , renderAlpha(1.0f)
 {
 }
 
@@ -26,6 +28,13 @@ void FlappyApp::onStart() {
     gameTime = 0.0f;
 }
 
+void FlappyApp::onPause() {
+    // The app is kept suspended; freeze the run until the player is back
+    if (state == PLAYING) {
+        state = PAUSED;
+    }
+}
+
 void FlappyApp::onStop() {
     std::cout << "FlappyApp: Stopped (High Score: " << highScore << ")" << std::endl;
 }
@@ -33,6 +42,13 @@ void FlappyApp::onStop() {
 void FlappyApp::update(float deltaTime) {
     gameTime += deltaTime;
 
+    // Remember where things were, for interpolated rendering
+    bird.previousY = bird.y;
+    for (auto& pipe : pipes) {
+        pipe.previousX = pipe.x;
+    }
+    previousGroundOffset = groundOffset;
+
     if (state == PLAYING) {
         updatePhysics(deltaTime);
         updatePipes(deltaTime);
@@ -45,6 +61,11 @@ void FlappyApp::update(float deltaTime) {
     }
 }
 
+void FlappyApp::renderInterpolated(Renderer& renderer, float alpha) {
+    renderAlpha = alpha;
+    render(renderer);
+}
+
 void FlappyApp::render(Renderer& renderer) {
     // Sky background
     renderer.drawRect(Rect(0, 0, renderer.getWidth(), renderer.getHeight()),
@@ -57,6 +78,9 @@ void FlappyApp::render(Renderer& renderer) {
         case PLAYING:
             renderGame(renderer);
             break;
+        case PAUSED:
+            renderPaused(renderer);
+            break;
         case GAME_OVER:
             renderGameOver(renderer);
             break;
@@ -76,6 +100,9 @@ void FlappyApp::onEvent(const Event& event) {
             std::cout << "FlappyApp: Game started!" << std::endl;
         } else if (state == PLAYING) {
             flap();
+        } else if (state == PAUSED) {
+            state = PLAYING;
+            std::cout << "FlappyApp: Game resumed" << std::endl;
         } else if (state == GAME_OVER) {
             state = MENU;
         }
@@ -94,6 +121,7 @@ void FlappyApp::resetGame() {
     pipes.clear();
     score = 0;
     groundOffset = 0.0f;
+    previousGroundOffset = 0.0f;
 
     // Spawn initial pipes
     for (int i = 0; i < 4; i++) {
@@ -291,6 +319,27 @@ void FlappyApp::renderGame(Renderer& renderer) {
     renderer.drawText("ENTER/UP: Flap | ESC: Exit", 20, renderer.getHeight() - 50, Color(150, 150, 150), 18);
 }
 
+void FlappyApp::renderPaused(Renderer& renderer) {
+    // Render game elements (frozen state)
+    renderPipes(renderer);
+    renderGround(renderer);
+    renderBird(renderer);
+    renderScore(renderer);
+
+    // Semi-transparent overlay
+    renderer.drawRect(Rect(0, 0, renderer.getWidth(), renderer.getHeight()),
+                      Color(0, 0, 0, 150), true);
+
+    int centerX = renderer.getWidth() / 2;
+    int centerY = renderer.getHeight() / 2;
+
+    renderer.drawText("PAUSED", centerX - 60, centerY - 40, Color::White(), 32);
+    renderer.drawText("Press ENTER to continue", centerX - 120, centerY + 20, Color(200, 200, 200), 18);
+
+    // Controls
+    renderer.drawText("Press ESC to return to Home", 20, renderer.getHeight() - 50, Color(150, 150, 150), 18);
+}
+
 void FlappyApp::renderGameOver(Renderer& renderer) {
     // Render game elements (frozen state)
     renderPipes(renderer);
@@ -337,7 +386,7 @@ void FlappyApp::renderGameOver(Renderer& renderer) {
 
 void FlappyApp::renderBird(Renderer& renderer) {
     int birdX = (int)bird.x;
-    int birdY = (int)bird.y;
+    int birdY = (int)(bird.previousY + (bird.y - bird.previousY) * renderAlpha);
 
     // Bird body (yellow circle approximation with rectangles)
     renderer.drawRect(Rect(birdX, birdY, bird.width, bird.height), Color(255, 200, 0), true);
@@ -361,7 +410,7 @@ void FlappyApp::renderBird(Renderer& renderer) {
 
 void FlappyApp::renderPipes(Renderer& renderer) {
     for (const auto& pipe : pipes) {
-        int pipeX = (int)pipe.x;
+        int pipeX = (int)(pipe.previousX + (pipe.x - pipe.previousX) * renderAlpha);
 
         // Top pipe
         int topHeight = pipe.getTopHeight();
@@ -404,7 +453,10 @@ void FlappyApp::renderGround(Renderer& renderer) {
 
     // Ground pattern (animated scrolling)
     int patternWidth = 50;
-    int offset = (int)groundOffset;
+
+    // The offset wraps back to 0 every pattern width
+    float current = groundOffset < previousGroundOffset ? groundOffset + patternWidth : groundOffset;
+    int offset = (int)(previousGroundOffset + (current - previousGroundOffset) * renderAlpha) % patternWidth;
     for (int x = -offset; x < renderer.getWidth(); x += patternWidth) {
         renderer.drawRect(Rect(x, groundY, 2, GROUND_HEIGHT),
                          Color(180, 150, 110), true);
@@ -21,6 +21,13 @@ namespace AOS {
  * Controls:
  * - SPACE/ENTER: Flap (jump)
  * - ESC: Return to home
+ *
+ * Leaving mid-game pauses the run; it stays frozen, score and pipes
+ * included, until ENTER is pressed after coming back.
+ *
+ * The game runs on a fixed PHYSICS_STEP, so it plays the same at any
+ * frame rate and a long frame can't carry the bird through a pipe.
+ * Moving things are drawn interpolated between the last two steps.
  */
 class FlappyApp : public App {
 public:
@@ -28,41 +35,48 @@ public:
     ~FlappyApp() override = default;
 
     void onStart() override;
+    void onPause() override;
     void onStop() override;
     void update(float deltaTime) override;
+    float getFixedTimestep() const override { return PHYSICS_STEP; }
     void render(Renderer& renderer) override;
+    void renderInterpolated(Renderer& renderer, float alpha) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "Flappy Bird"; }
+    static constexpr const char* NAME = "Flappy Bird";
+    std::string getName() const override { return NAME; }
 
 private:
     // Game states
     enum GameState {
         MENU,
         PLAYING,
+        PAUSED,
         GAME_OVER
     };
 
     // Bird structure
     struct Bird {
         float x, y;           // Position
+        float previousY;      // Position at the previous step
         float velocity;       // Vertical velocity
         float rotation;       // Visual rotation angle
         int width, height;    // Collision box
 
-        Bird() : x(200), y(300), velocity(0), rotation(0), width(34), height(24) {}
+        Bird() : x(200), y(300), previousY(300), velocity(0), rotation(0), width(34), height(24) {}
     };
 
     // Pipe structure
     struct Pipe {
         float x;              // Horizontal position
+        float previousX;      // Position at the previous step
         float gapY;           // Center Y of the gap
         int gapSize;          // Size of the gap
         int width;            // Pipe width
         bool scored;          // Has the player scored from this pipe?
 
         Pipe(float posX, float gapYPos, int gap)
-            : x(posX), gapY(gapYPos), gapSize(gap), width(80), scored(false) {}
+            : x(posX), previousX(posX), gapY(gapYPos), gapSize(gap), width(80), scored(false) {}
 
         // Get top pipe bounds
         int getTopHeight() const { return (int)(gapY - gapSize / 2); }
@@ -77,6 +91,7 @@ private:
     std::vector<Pipe> pipes;
 
     // Physics constants
+    static constexpr float PHYSICS_STEP = 1.0f / 120.0f;
     const float GRAVITY = 1200.0f;          // Pixels per second^2
     const float FLAP_VELOCITY = -400.0f;    // Initial jump velocity
     const float MAX_VELOCITY = 800.0f;      // Terminal velocity
@@ -98,6 +113,8 @@ private:
     // Animation
     float gameTime;
     float groundOffset;
+    float previousGroundOffset;
+    float renderAlpha;            // Interpolation between the last two steps
 
     // Game methods
     void resetGame();
@@ -116,6 +133,7 @@ private:
     // Rendering methods
     void renderMenu(Renderer& renderer);
     void renderGame(Renderer& renderer);
+    void renderPaused(Renderer& renderer);
     void renderGameOver(Renderer& renderer);
     void renderBird(Renderer& renderer);
     void renderPipes(Renderer& renderer);
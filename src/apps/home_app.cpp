@@ -10,11 +10,15 @@ namespace AOS {
 
 HomeApp::HomeApp()
     : focusedIndex(0)
+    , prewarmTimer()
     , globalTime(0.0f)
     , focusTransition(1.0f)
     , previousFocusIndex(0)
     , scrollOffset(0.0f)
     , targetScrollOffset(0.0f)
+    , sceneWidth(0)
+    , sceneHeight(0)
+    , sceneStale(true)
 {
 }
 
@@ -22,6 +26,17 @@ void HomeApp::onStart() {
     std::cout << "HomeApp: Started with modern UI" << std::endl;
 }
 
+void HomeApp::onPause() {
+    TimerService::getInstance().cancel(prewarmTimer);
+
+    // Layer textures aren't needed while another app is on screen
+    scene.releaseLayers();
+}
+
+void HomeApp::onStop() {
+    scene.releaseLayers();
+}
+
 void HomeApp::onResume() {
     // Refresh app list each time we return to home
     refreshAppList();
@@ -51,6 +66,7 @@ void HomeApp::updateAnimations(float deltaTime) {
     for (size_t i = 0; i < appTiles.size(); ++i) {
         auto& tile = appTiles[i];
         
+        float previousHover = tile.hoverAnimation;
         float targetHover = (i == focusedIndex) ? 1.0f : 0.0f;
         float hoverDiff = targetHover - tile.hoverAnimation;
         tile.hoverAnimation += hoverDiff * deltaTime * 10.0f;
@@ -58,33 +74,68 @@ void HomeApp::updateAnimations(float deltaTime) {
         // Clamp
         if (tile.hoverAnimation < 0.0f) tile.hoverAnimation = 0.0f;
         if (tile.hoverAnimation > 1.0f) tile.hoverAnimation = 1.0f;
+
+        // Settle on the target so the cached tile stops being redrawn
+        if (std::fabs(targetHover - tile.hoverAnimation) < 0.001f) {
+            tile.hoverAnimation = targetHover;
+        }
+        if (tile.hoverAnimation != previousHover && i < tileNodes.size()) {
+            tileNodes[i]->invalidate();
+        }
     }
 }
 
 void HomeApp::render(Renderer& renderer) {
-    // Simple clean gradient background
-    Color bgTop(16, 20, 38);
-    Color bgBottom(10, 12, 22);
-    renderer.drawGradientRect(Rect(0, 0, renderer.getWidth(), renderer.getHeight()), bgTop, bgBottom);
-    
-    // Draw header
-    drawModernHeader(renderer);
-    
-    // Draw app tiles
+    if (sceneStale || renderer.getWidth() != sceneWidth || renderer.getHeight() != sceneHeight) {
+        buildScene(renderer.getWidth(), renderer.getHeight());
+    }
+
+    // Tiles follow the scroll offset; moving a cached tile is free
+    for (size_t i = 0; i < tileNodes.size(); ++i) {
+        const AppTile& tile = appTiles[i];
+        int drawY = tile.y + (int)scrollOffset;
+        tileNodes[i]->setPosition(tile.x, drawY);
+        tileNodes[i]->setVisible(drawY + tile.h >= HEADER_HEIGHT && drawY <= sceneHeight - 70);
+    }
+
+    scene.render(renderer);
+}
+
+void HomeApp::buildScene(int width, int height) {
+    scene.clearChildren();
+    tileNodes.clear();
+    sceneWidth = width;
+    sceneHeight = height;
+    sceneStale = false;
+
+    // Simple clean gradient background (already a single cached quad)
+    scene.addChild([width, height](Renderer& renderer) {
+        Color bgTop(16, 20, 38);
+        Color bgBottom(10, 12, 22);
+        renderer.drawGradientRect(Rect(0, 0, width, height), bgTop, bgBottom);
+    });
+
+    SceneNode* header = scene.addChild([this](Renderer& renderer) { drawModernHeader(renderer); });
+    header->setBounds(Rect(0, 0, width, HEADER_HEIGHT));
+    header->setCacheable(true, true);
+
+    // Pulsing accent line and status dot change every frame
+    scene.addChild([this](Renderer& renderer) { drawHeaderAccents(renderer); });
+
     for (size_t i = 0; i < appTiles.size(); ++i) {
-        drawModernTile(renderer, appTiles[i], (int)i);
+        SceneNode* tileNode = scene.addChild([this, i](Renderer& renderer) {
+            drawModernTile(renderer, appTiles[i], (int)i);
+        });
+        tileNode->setBounds(Rect(-TILE_LAYER_MARGIN, -TILE_LAYER_MARGIN,
+                                 TILE_WIDTH + 2 * TILE_LAYER_MARGIN, TILE_HEIGHT + 2 * TILE_LAYER_MARGIN));
+        tileNode->setCacheable(true);
+        tileNodes.push_back(tileNode);
     }
-    
-    // Clean footer
-    int footerY = renderer.getHeight() - 65;
-    Color footerBg(15, 18, 30, 240);
-    renderer.drawRect(Rect(0, footerY, renderer.getWidth(), 65), footerBg, true);
-    renderer.drawLine(0, footerY, renderer.getWidth(), footerY, Color(80, 110, 180, 100), 1);
-    
-    std::string instructions = "Navigate: UP/DOWN     Select: ENTER     Back: ESC";
-    int textWidth = instructions.length() * 10;
-    int textX = (renderer.getWidth() - textWidth) / 2;
-    renderer.drawText(instructions, textX, footerY + 24, Color(190, 200, 220), 18);
+
+    SceneNode* footer = scene.addChild([this](Renderer& renderer) { drawFooter(renderer); });
+    footer->setPosition(0, height - FOOTER_HEIGHT);
+    footer->setBounds(Rect(0, 0, width, FOOTER_HEIGHT));
+    footer->setCacheable(true, true);
 }
 
 void HomeApp::drawModernHeader(Renderer& renderer) {
@@ -92,12 +143,6 @@ void HomeApp::drawModernHeader(Renderer& renderer) {
     Color headerBg(20, 25, 45);
     renderer.drawRect(Rect(0, 0, renderer.getWidth(), HEADER_HEIGHT), headerBg, true);
     
-    // Single clean accent line
-    float pulse = (sinf(globalTime * 2.0f) + 1.0f) * 0.5f;
-    int accentAlpha = 120 + (int)(80 * pulse);
-    renderer.drawLine(0, HEADER_HEIGHT - 2, renderer.getWidth(), HEADER_HEIGHT - 2,
-                     Color(100, 150, 240, accentAlpha), 2);
-    
     // Logo text
     renderer.drawText("A-OS", 45, 28, Color(255, 255, 255), 42);
     renderer.drawText("Application Operating System", 48, 68, Color(160, 175, 200), 15);
@@ -105,47 +150,64 @@ void HomeApp::drawModernHeader(Renderer& renderer) {
     // System status
     int statusX = renderer.getWidth() - 190;
     int statusY = 42;
+    renderer.drawText("System Active", statusX + 18, statusY, Color(200, 215, 235), 17);
+}
+
+void HomeApp::drawHeaderAccents(Renderer& renderer) {
+    // Single clean accent line
+    float pulse = (sinf(globalTime * 2.0f) + 1.0f) * 0.5f;
+    int accentAlpha = 120 + (int)(80 * pulse);
+    renderer.drawLine(0, HEADER_HEIGHT - 2, renderer.getWidth(), HEADER_HEIGHT - 2,
+                     Color(100, 150, 240, accentAlpha), 2);
     
     // Animated status dot
-    int dotX = statusX;
-    int dotY = statusY + 8;
+    int dotX = renderer.getWidth() - 190;
+    int dotY = 42 + 8;
     float dotPulse = (sinf(globalTime * 3.0f) + 1.0f) * 0.5f;
     int dotSize = 5 + (int)(2 * dotPulse);
     renderer.drawCircle(dotX, dotY, dotSize, Color(80, 255, 150), true);
+}
+
+void HomeApp::drawFooter(Renderer& renderer) {
+    // Clean footer (drawn at the footer node's origin)
+    Color footerBg(15, 18, 30, 240);
+    renderer.drawRect(Rect(0, 0, renderer.getWidth(), FOOTER_HEIGHT), footerBg, true);
+    renderer.drawLine(0, 0, renderer.getWidth(), 0, Color(80, 110, 180, 100), 1);
     
-    renderer.drawText("System Active", dotX + 18, statusY, Color(200, 215, 235), 17);
+    std::string instructions = "Navigate: UP/DOWN     Select: ENTER     Back: ESC";
+    int textWidth = instructions.length() * 10;
+    int textX = (renderer.getWidth() - textWidth) / 2;
+    renderer.drawText(instructions, textX, 24, Color(190, 200, 220), 18);
 }
 
 void HomeApp::drawModernTile(Renderer& renderer, const AppTile& tile, int index) {
     float hover = tile.hoverAnimation;
     
-    int drawY = tile.y + (int)scrollOffset;
-    
-    if (drawY + tile.h < HEADER_HEIGHT || drawY > renderer.getHeight() - 70) {
-        return;
-    }
+    // Drawn at the tile node's origin; render() positions the node
+    int tileX = 0;
+    int drawY = 0;
     
     // Subtle shadow only when focused
     if (hover > 0.3f) {
-        renderer.drawShadow(Rect(tile.x, drawY, tile.w, tile.h), 6, 12);
+        renderer.drawShadow(Rect(tileX, drawY, tile.w, tile.h), 6, 12);
     }
     
     // Clean, solid dark card
     Color cardBg(28 + (int)(15 * hover), 32 + (int)(18 * hover), 52 + (int)(30 * hover));
-    renderer.drawRect(Rect(tile.x, drawY, tile.w, tile.h), cardBg, true);
+    renderer.drawRect(Rect(tileX, drawY, tile.w, tile.h), cardBg, true);
     
     // Border when focused
     if (hover > 0.5f) {
         Color borderColor(100 + (int)(100 * hover), 140 + (int)(80 * hover), 220, (int)(200 * hover));
         // Draw border manually for clean lines
         for (int i = 0; i < 2; ++i) {
-            renderer.drawRect(Rect(tile.x + i, drawY + i, tile.w - i*2, tile.h - i*2), borderColor, false);
+            renderer.drawRect(Rect(tileX + i, drawY + i, tile.w - i*2, tile.h - i*2), borderColor, false);
         }
     }
     
     // Professional app icon
     int iconSize = 54 + (int)(6 * hover);
-    int iconX = tile.x + 30;
+    int iconX = tileX + 30;
     int iconY = drawY + (tile.h - iconSize) / 2;
     drawAppIcon(renderer, iconX, iconY, iconSize, tile.iconHue, hover);
     
@@ -159,7 +221,7 @@ void HomeApp::drawModernTile(Renderer& renderer, const AppTile& tile, int index)
     
     // Simple arrow when focused
     if (hover > 0.5f) {
-        int arrowX = tile.x + tile.w - 50;
+        int arrowX = tileX + tile.w - 50;
         int arrowY = drawY + tile.h / 2;
         Color arrowColor(200, 220, 255);
         renderer.drawLine(arrowX, arrowY, arrowX + 14, arrowY, arrowColor, 2);
@@ -168,7 +230,7 @@ void HomeApp::drawModernTile(Renderer& renderer, const AppTile& tile, int index)
     }
     
     // Number badge
-    int badgeX = tile.x + tile.w - 28;
+    int badgeX = tileX + tile.w - 28;
     int badgeY = drawY + 18;
     Color badgeBg(50 + (int)(20 * hover), 55 + (int)(25 * hover), 80 + (int)(30 * hover));
     renderer.drawCircle(badgeX, badgeY, 14, badgeBg, true);
@@ -268,12 +330,12 @@ void HomeApp::refreshAppList() {
 
     for (size_t i = 0; i < apps.size(); ++i) {
         // Skip self (Home app)
-        if (apps[i]->getName() == "Home") {
+        if (apps[i].name == NAME) {
             continue;
         }
 
         AppTile tile;
-        tile.name = apps[i]->getName();
+        tile.name = apps[i].name;
         tile.x = startX;
         tile.y = startY + tileIndex * (TILE_HEIGHT + TILE_SPACING);
         tile.w = TILE_WIDTH;
@@ -299,6 +361,9 @@ void HomeApp::refreshAppList() {
     // Reset animations
     focusTransition = 1.0f;
     previousFocusIndex = focusedIndex;
+    sceneStale = true;
+
+    schedulePrewarm();
 }
 
 void HomeApp::moveFocusUp() {
@@ -312,6 +377,7 @@ void HomeApp::moveFocusUp() {
         // Update target scroll offset for smooth scrolling
         int targetY = appTiles[focusedIndex].y;
         targetScrollOffset = -(targetY - TILE_START_Y);
+        schedulePrewarm();
     }
 
     for (size_t i = 0; i < appTiles.size(); ++i) {
@@ -330,6 +396,7 @@ void HomeApp::moveFocusDown() {
         // Update target scroll offset for smooth scrolling
         int targetY = appTiles[focusedIndex].y;
         targetScrollOffset = -(targetY - TILE_START_Y);
+        schedulePrewarm();
     }
 
     for (size_t i = 0; i < appTiles.size(); ++i) {
@@ -348,4 +415,20 @@ void HomeApp::launchFocusedApp() {
     g_appManager->launchAppByName(focusedApp.name);
 }
 
+void HomeApp::schedulePrewarm() {
+    // Only once the focus stays put; scrolling past a tile shouldn't
+    // start anything
+    TimerService& timers = TimerService::getInstance();
+    timers.cancel(prewarmTimer);
+    if (appTiles.empty()) {
+        return;
+    }
+
+    prewarmTimer = timers.schedule(PREWARM_DELAY_MS, [this]() {
+        if (g_appManager && focusedIndex < appTiles.size()) {
+            g_appManager->prewarmAppByName(appTiles[focusedIndex].name);
+        }
+    });
+}
+
 } // namespace AOS
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "os/app.h"
+#include "os/timer_service.h"
 #include "ui/renderer.h"
+#include "ui/scene_graph.h"
 #include <vector>
 
 namespace AOS {
@@ -16,6 +18,14 @@ namespace AOS {
  *
  * This app is special: it's always the first app registered
  * and the OS returns here when pressing "back" from other apps.
+ *
+ * The screen is a retained scene: header, footer and each tile are cached
+ * layers, so only the animated accents are drawn from scratch each frame
+ * and a tile is redrawn only while its focus animation runs.
+ *
+ * When the focus has rested on a tile for PREWARM_DELAY_MS the app behind
+ * it is prewarmed (see AppManager), so selecting it opens in about a
+ * frame.
  */
 class HomeApp : public App {
 public:
@@ -23,12 +33,15 @@ public:
     ~HomeApp() override = default;
 
     void onStart() override;
+    void onPause() override;
+    void onStop() override;
     void onResume() override;
     void update(float deltaTime) override;
     void render(Renderer& renderer) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "Home"; }
+    static constexpr const char* NAME = "Home";
+    std::string getName() const override { return NAME; }
 
 private:
     struct AppTile {
@@ -41,6 +54,7 @@ private:
 
     std::vector<AppTile> appTiles;
     size_t focusedIndex;
+    TimerService::TimerHandle prewarmTimer;
     
     // Animation state
     float globalTime;             // Total elapsed time for animations
@@ -48,6 +62,13 @@ private:
     size_t previousFocusIndex;    // For smooth transitions
     float scrollOffset;           // Smooth scrolling offset
     float targetScrollOffset;     // Target scroll position
+
+    // Retained scene (rebuilt when the app list or screen size changes)
+    SceneNode scene;
+    std::vector<SceneNode*> tileNodes;
+    int sceneWidth;
+    int sceneHeight;
+    bool sceneStale;
     
     // UI Layout constants
     static constexpr int TILE_WIDTH = 500;
@@ -56,13 +77,20 @@ private:
     static constexpr int TILE_MARGIN_LEFT = 80;
     static constexpr int TILE_START_Y = 140;
     static constexpr int HEADER_HEIGHT = 100;
+    static constexpr int FOOTER_HEIGHT = 65;
+    static constexpr int TILE_LAYER_MARGIN = 20;   // Room for the focus shadow
+    static constexpr uint32_t PREWARM_DELAY_MS = 150;
 
     void refreshAppList();
     void moveFocusUp();
     void moveFocusDown();
     void launchFocusedApp();
+    void schedulePrewarm();
     void updateAnimations(float deltaTime);
+    void buildScene(int width, int height);
     void drawModernHeader(Renderer& renderer);
+    void drawHeaderAccents(Renderer& renderer);
+    void drawFooter(Renderer& renderer);
     void drawModernTile(Renderer& renderer, const AppTile& tile, int index);
     void drawAppIcon(Renderer& renderer, int x, int y, int size, float hue, float hover = 0.0f);
 };
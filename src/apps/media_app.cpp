@@ -1,6 +1,8 @@
 #include "media_app.h"
 #include "os/app_manager.h"
+#include "os/timer_service.h"
 #include <iostream>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
@@ -24,6 +26,8 @@ MediaApp::MediaApp()
     , trackPosition(0.0f)
     , trackDuration(0.0f)
     , currentTrack(0)
+    , playStartedAt(0)
+    , endOfTrackTimer()
 {
 }
 
@@ -34,19 +38,16 @@ void MediaApp::onStart() {
 
 void MediaApp::onStop() {
     std::cout << "MediaApp: Stopped" << std::endl;
+    TimerService::getInstance().cancel(endOfTrackTimer);
     state = STOPPED;
 }
 
-void MediaApp::update(float deltaTime) {
-    if (state == PLAYING) {
-        trackPosition += deltaTime;
-
-        // Loop track when finished
-        if (trackPosition >= trackDuration) {
-            trackPosition = 0.0f;
-            nextTrack();
-        }
+float MediaApp::getPosition() const {
+    if (state != PLAYING) {
+        return trackPosition;
     }
+    float elapsed = (TimerService::getInstance().getNow() - playStartedAt) / 1000.0f;
+    return std::min(trackPosition + elapsed, trackDuration);
 }
 
 void MediaApp::render(Renderer& renderer) {
@@ -58,7 +59,8 @@ void MediaApp::render(Renderer& renderer) {
     int centerY = renderer.getHeight() / 2;
 
     // Album art placeholder (animated when playing)
-    float rotation = state == PLAYING ? trackPosition * 20.0f : 0.0f;
+    float position = getPosition();
+    float rotation = state == PLAYING ? position * 20.0f : 0.0f;
     int artSize = 200;
     int artX = centerX - artSize / 2;
     int artY = 150;
@@ -117,7 +119,7 @@ void MediaApp::render(Renderer& renderer) {
     );
 
     // Progress
-    float progress = trackDuration > 0 ? trackPosition / trackDuration : 0.0f;
+    float progress = trackDuration > 0 ? position / trackDuration : 0.0f;
     int progressWidth = (int)(barWidth * progress);
     renderer.drawRect(
         Rect(barX, barY, progressWidth, barHeight),
@@ -136,7 +138,7 @@ void MediaApp::render(Renderer& renderer) {
     };
 
     renderer.drawText(
-        formatTime(trackPosition),
+        formatTime(position),
         barX,
         barY + 20,
         Color(150, 150, 150),
@@ -199,14 +201,27 @@ void MediaApp::onEvent(const Event& event) {
 
 void MediaApp::togglePlayPause() {
     if (state == PLAYING) {
+        trackPosition = getPosition();
+        TimerService::getInstance().cancel(endOfTrackTimer);
         state = PAUSED;
         std::cout << "MediaApp: Paused" << std::endl;
     } else {
-        state = PLAYING;
+        startPlayback();
         std::cout << "MediaApp: Playing - " << tracks[currentTrack].title << std::endl;
     }
 }
 
+void MediaApp::startPlayback() {
+    TimerService& timers = TimerService::getInstance();
+    state = PLAYING;
+    playStartedAt = timers.getNow();
+
+    // Loop on to the next track when this one finishes
+    uint32_t remainingMs = (uint32_t)((trackDuration - trackPosition) * 1000.0f);
+    timers.cancel(endOfTrackTimer);
+    endOfTrackTimer = timers.schedule(remainingMs, [this]() { nextTrack(); });
+}
+
 void MediaApp::nextTrack() {
     currentTrack = (currentTrack + 1) % trackCount;
     loadTrack(currentTrack);
@@ -226,7 +241,7 @@ void MediaApp::loadTrack(int index) {
 
     // Auto-play when changing tracks
     if (state != STOPPED) {
-        state = PLAYING;
+        startPlayback();
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "os/app.h"
+#include "os/timer_service.h"
 #include "ui/renderer.h"
 #include <string>
 
@@ -27,11 +28,11 @@ public:
 
     void onStart() override;
     void onStop() override;
-    void update(float deltaTime) override;
     void render(Renderer& renderer) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "Media Player"; }
+    static constexpr const char* NAME = "Media Player";
+    std::string getName() const override { return NAME; }
 
 private:
     enum PlayState {
@@ -41,9 +42,11 @@ private:
     };
 
     PlayState state;
-    float trackPosition;
+    float trackPosition;          // Seconds; as of playStartedAt while playing
     float trackDuration;
     int currentTrack;
+    uint64_t playStartedAt;       // TimerService clock (ms)
+    TimerService::TimerHandle endOfTrackTimer;
 
     struct Track {
         std::string title;
@@ -54,6 +57,8 @@ private:
     static const Track tracks[];
     static const int trackCount;
 
+    float getPosition() const;
+    void startPlayback();
     void togglePlayPause();
     void nextTrack();
     void prevTrack();
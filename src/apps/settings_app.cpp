@@ -33,6 +33,7 @@ void SettingsApp::render(Renderer& renderer) {
 
     float wave = std::sin(animationTime * 2.0f) * 0.5f + 0.5f;
     int size = 50 + (int)(wave * 30);
+    animationBounds = Rect(centerX - 40, centerY - 40, 80, 80);
 
     Color boxColor(100 + (int)(wave * 155), 100, 100);
     renderer.drawRect(
@@ -49,6 +50,11 @@ void SettingsApp::render(Renderer& renderer) {
     renderer.drawText("Press ESC to return to Home", 20, renderer.getHeight() - 50, Color(150, 150, 150), 18);
 }
 
+bool SettingsApp::collectDamage(std::vector<Rect>& regions) {
+    regions.push_back(animationBounds);
+    return true;
+}
+
 void SettingsApp::onEvent(const Event& event) {
     // Back button returns to home
     if (event.type == EventType::KEY_BACK) {
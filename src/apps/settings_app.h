@@ -29,12 +29,17 @@ public:
     void onStop() override;
     void update(float deltaTime) override;
     void render(Renderer& renderer) override;
+    bool collectDamage(std::vector<Rect>& regions) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "Settings"; }
+    static constexpr const char* NAME = "Settings";
+    std::string getName() const override { return NAME; }
 
 private:
     float animationTime;
+
+    // Area the pulsing box can cover; the rest of the screen is static
+    Rect animationBounds{0, 0, 0, 0};
 };
 
 } // namespace AOS
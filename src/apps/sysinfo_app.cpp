@@ -1,8 +1,11 @@
 #include "sysinfo_app.h"
 #include "os/app_manager.h"
+#include "os/job_system.h"
+#include "os/timer_service.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <memory>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -17,12 +20,19 @@ namespace AOS {
 
 SysInfoApp::SysInfoApp()
     : uptimeSeconds(0.0f)
+    , uptimeChanged(false)
+    , infoChanged(false)
+    , uptimeBounds(0, 0, 0, 0)
+    , uptimeTimer()
 {
 }
 
+void SysInfoApp::onPrewarm() {
+    collectSystemInfo(prewarmedItems);
+}
+
 void SysInfoApp::onStart() {
     std::cout << "SysInfoApp: Started" << std::endl;
-    refreshSystemInfo();
 }
 
 void SysInfoApp::onStop() {
@@ -30,34 +40,47 @@ void SysInfoApp::onStop() {
 }
 
 void SysInfoApp::onResume() {
-    refreshSystemInfo();
+    // Prewarmed info is shown from the first frame; otherwise it arrives
+    // a few frames in
+    if (!prewarmedItems.empty()) {
+        infoItems = std::move(prewarmedItems);
+        prewarmedItems.clear();
+        infoChanged = true;
+        refreshUptime();
+    } else {
+        refreshSystemInfo();
+    }
+
+    // Update uptime display every second, while on screen
+    uptimeTimer = TimerService::getInstance().scheduleRepeating(1000, [this]() { refreshUptime(); });
+}
+
+void SysInfoApp::onPause() {
+    TimerService::getInstance().cancel(uptimeTimer);
 }
 
 void SysInfoApp::update(float deltaTime) {
     uptimeSeconds += deltaTime;
+}
+
+void SysInfoApp::refreshUptime() {
+    int hours = (int)(uptimeSeconds / 3600);
+    int minutes = (int)((uptimeSeconds - hours * 3600) / 60);
+    int seconds = (int)(uptimeSeconds) % 60;
+
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(2) << hours << ":"
+        << std::setfill('0') << std::setw(2) << minutes << ":"
+        << std::setfill('0') << std::setw(2) << seconds;
 
-    // Update uptime display every second
-    static float lastUpdate = 0.0f;
-    lastUpdate += deltaTime;
-    if (lastUpdate >= 1.0f) {
-        lastUpdate = 0.0f;
-
-        // Update uptime in info items
-        int hours = (int)(uptimeSeconds / 3600);
-        int minutes = (int)((uptimeSeconds - hours * 3600) / 60);
-        int seconds = (int)(uptimeSeconds) % 60;
-
-        std::ostringstream oss;
-        oss << std::setfill('0') << std::setw(2) << hours << ":"
-            << std::setfill('0') << std::setw(2) << minutes << ":"
-            << std::setfill('0') << std::setw(2) << seconds;
-
-        // Find and update uptime
-        for (auto& item : infoItems) {
-            if (item.label == "Uptime:") {
+    // Find and update uptime in info items
+    for (auto& item : infoItems) {
+        if (item.label == "Uptime:") {
+            if (item.value != oss.str()) {
                 item.value = oss.str();
-                break;
+                uptimeChanged = true;
             }
+            break;
         }
     }
 }
@@ -83,6 +106,10 @@ void SysInfoApp::render(Renderer& renderer) {
             20
         );
 
+        if (infoItems[i].label == "Uptime:") {
+            uptimeBounds = Rect(300, y, renderer.getWidth() - 300, lineHeight);
+        }
+
         // Value
         renderer.drawText(
             infoItems[i].value,
@@ -104,6 +131,23 @@ void SysInfoApp::render(Renderer& renderer) {
     renderer.drawText("Press ESC to return to Home", 20, renderer.getHeight() - 50, Color(150, 150, 150), 18);
 }
 
+bool SysInfoApp::collectDamage(std::vector<Rect>& regions) {
+    // New system info: redraw everything
+    if (infoChanged) {
+        infoChanged = false;
+        uptimeChanged = false;
+        return true;
+    }
+
+    if (!uptimeChanged) {
+        return false;
+    }
+
+    uptimeChanged = false;
+    regions.push_back(uptimeBounds);
+    return true;
+}
+
 void SysInfoApp::onEvent(const Event& event) {
     if (event.type == EventType::KEY_BACK) {
         std::cout << "SysInfoApp: Returning to home" << std::endl;
@@ -114,21 +158,35 @@ void SysInfoApp::onEvent(const Event& event) {
 }
 
 void SysInfoApp::refreshSystemInfo() {
-    infoItems.clear();
+    // uname()/sysconf() can block (and on the Pi will read sensors and
+    // /proc), so gather on a worker and swap the result in on the main
+    // thread
+    auto items = std::make_shared<std::vector<InfoItem>>();
+    JobSystem::getInstance().submit(
+        [items]() { collectSystemInfo(*items); },
+        [this, items]() {
+            infoItems = std::move(*items);
+            infoChanged = true;
+            refreshUptime();
+        });
+}
+
+void SysInfoApp::collectSystemInfo(std::vector<InfoItem>& items) {
+    items.clear();
 
     // OS Name and Version
-    infoItems.push_back({"OS Name:", "A-OS (Application Operating System)"});
-    infoItems.push_back({"Version:", "v0.2 - Text Rendering"});
+    items.push_back({"OS Name:", "A-OS (Application Operating System)"});
+    items.push_back({"Version:", "v0.2 - Text Rendering"});
 
     // Platform detection
 #ifdef _WIN32
-    infoItems.push_back({"Platform:", "Windows (Desktop Simulation)"});
+    items.push_back({"Platform:", "Windows (Desktop Simulation)"});
 
     SYSTEM_INFO sysInfo;
     GetSystemInfo(&sysInfo);
     std::ostringstream cpuOss;
     cpuOss << "x86_64 (" << sysInfo.dwNumberOfProcessors << " cores)";
-    infoItems.push_back({"CPU:", cpuOss.str()});
+    items.push_back({"CPU:", cpuOss.str()});
 
     MEMORYSTATUSEX memInfo;
     memInfo.dwLength = sizeof(MEMORYSTATUSEX);
@@ -136,16 +194,16 @@ void SysInfoApp::refreshSystemInfo() {
     DWORDLONG totalPhysMem = memInfo.ullTotalPhys;
     std::ostringstream memOss;
     memOss << (totalPhysMem / 1024 / 1024) << " MB";
-    infoItems.push_back({"Memory:", memOss.str()});
+    items.push_back({"Memory:", memOss.str()});
 
 #else
     struct utsname unameData;
     if (uname(&unameData) == 0) {
-        infoItems.push_back({"Platform:", std::string(unameData.sysname)});
-        infoItems.push_back({"Kernel:", std::string(unameData.release)});
-        infoItems.push_back({"Architecture:", std::string(unameData.machine)});
+        items.push_back({"Platform:", std::string(unameData.sysname)});
+        items.push_back({"Kernel:", std::string(unameData.release)});
+        items.push_back({"Architecture:", std::string(unameData.machine)});
     } else {
-        infoItems.push_back({"Platform:", "Linux/Unix"});
+        items.push_back({"Platform:", "Linux/Unix"});
     }
 
     long pages = sysconf(_SC_PHYS_PAGES);
@@ -153,19 +211,19 @@ void SysInfoApp::refreshSystemInfo() {
     if (pages > 0 && page_size > 0) {
         std::ostringstream memOss;
         memOss << (pages * page_size / 1024 / 1024) << " MB";
-        infoItems.push_back({"Memory:", memOss.str()});
+        items.push_back({"Memory:", memOss.str()});
     }
 #endif
 
     // Graphics
-    infoItems.push_back({"Graphics:", "SDL2 Renderer"});
-    infoItems.push_back({"Display:", "1280x720 (Simulated)"});
+    items.push_back({"Graphics:", "SDL2 Renderer"});
+    items.push_back({"Display:", "1280x720 (Simulated)"});
 
-    // Uptime (will be updated in update())
-    infoItems.push_back({"Uptime:", "00:00:00"});
+    // Uptime (updated by the uptime timer)
+    items.push_back({"Uptime:", "00:00:00"});
 
     // Target hardware info
-    infoItems.push_back({"Target:", "Raspberry Pi 5 (4GB/8GB)"});
+    items.push_back({"Target:", "Raspberry Pi 5 (4GB/8GB)"});
 }
 
 } // namespace AOS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "os/app.h"
+#include "os/timer_service.h"
 #include "ui/renderer.h"
 #include <string>
 #include <vector>
@@ -27,14 +28,18 @@ public:
     SysInfoApp();
     ~SysInfoApp() override = default;
 
+    void onPrewarm() override;
     void onStart() override;
     void onStop() override;
     void onResume() override;
+    void onPause() override;
     void update(float deltaTime) override;
     void render(Renderer& renderer) override;
+    bool collectDamage(std::vector<Rect>& regions) override;
     void onEvent(const Event& event) override;
 
-    std::string getName() const override { return "System Info"; }
+    static constexpr const char* NAME = "System Info";
+    std::string getName() const override { return NAME; }
 
 private:
     struct InfoItem {
@@ -43,9 +48,21 @@ private:
     };
 
     std::vector<InfoItem> infoItems;
+    std::vector<InfoItem> prewarmedItems;   // Collected by onPrewarm()
     float uptimeSeconds;
 
+    // Only the uptime value changes once the screen is up, until a
+    // refresh delivers new info
+    bool uptimeChanged;
+    bool infoChanged;
+    Rect uptimeBounds;
+    TimerService::TimerHandle uptimeTimer;
+
     void refreshSystemInfo();
+    void refreshUptime();
+
+    // Runs on a worker thread
+    static void collectSystemInfo(std::vector<InfoItem>& items);
 };
 
 } // namespace AOS
@@ -1,9 +1,13 @@
 #include "input_manager.h"
+#include "os/event_recorder.h"
 
 namespace AOS {
 
 InputManager::InputManager()
     : quitRequested(false)
+    , redrawRequested(false)
+    , sizeChanged(false)
+    , recorder(nullptr)
 {
 }
 
@@ -13,47 +17,100 @@ InputManager::~InputManager() {
 void InputManager::pollInput() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                quitRequested = true;
-                break;
-
-            case SDL_KEYDOWN:
-                handleKeyDown(event.key.keysym.sym);
-                break;
-
-            case SDL_KEYUP:
-                handleKeyUp(event.key.keysym.sym);
-                break;
-
-            default:
-                break;
-        }
+        handleEvent(event);
     }
 }
 
-void InputManager::handleKeyDown(SDL_Keycode key) {
-    auto& eventBus = EventBus::getInstance();
+void InputManager::waitForInput(int timeoutMs) {
+    SDL_WaitEventTimeout(nullptr, timeoutMs);
+}
+
+bool InputManager::consumeRedrawRequest() {
+    bool requested = redrawRequested;
+    redrawRequested = false;
+    return requested;
+}
+
+bool InputManager::consumeSizeChange() {
+    bool changed = sizeChanged;
+    sizeChanged = false;
+    return changed;
+}
+
+void InputManager::handleEvent(const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_QUIT:
+            quitRequested = true;
+            break;
 
+        case SDL_KEYDOWN:
+            handleKeyDown(event.key.keysym.sym, event.key.timestamp);
+            break;
+
+        case SDL_KEYUP:
+            handleKeyUp(event.key.keysym.sym);
+            break;
+
+        case SDL_WINDOWEVENT:
+            if (event.window.event == SDL_WINDOWEVENT_EXPOSED ||
+                event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                event.window.event == SDL_WINDOWEVENT_RESTORED) {
+                redrawRequested = true;
+            }
+            if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                sizeChanged = true;
+            }
+            break;
+
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            redrawRequested = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void InputManager::publish(EventType type, Uint32 sdlTimestamp) {
+    Event event(type);
+
+    // SDL stamps events in SDL_GetTicks() milliseconds; carry that over
+    // to the event clock by how long ago it was
+    if (sdlTimestamp != 0) {
+        Uint32 ageMs = SDL_GetTicks() - sdlTimestamp;
+        event.timestamp = getEventClockNs() - (int64_t)ageMs * 1000000;
+    }
+
+    if (recorder) {
+        recorder->recordEvent(event);
+    }
+    EventBus::getInstance().publish(event);
+}
+
+void InputManager::handleKeyDown(SDL_Keycode key, Uint32 sdlTimestamp) {
     switch (key) {
         case SDLK_UP:
-            eventBus.publish(Event(EventType::KEY_UP));
+            publish(EventType::KEY_UP, sdlTimestamp);
             break;
         case SDLK_DOWN:
-            eventBus.publish(Event(EventType::KEY_DOWN));
+            publish(EventType::KEY_DOWN, sdlTimestamp);
             break;
         case SDLK_LEFT:
-            eventBus.publish(Event(EventType::KEY_LEFT));
+            publish(EventType::KEY_LEFT, sdlTimestamp);
             break;
         case SDLK_RIGHT:
-            eventBus.publish(Event(EventType::KEY_RIGHT));
+            publish(EventType::KEY_RIGHT, sdlTimestamp);
             break;
         case SDLK_RETURN:
         case SDLK_SPACE:
-            eventBus.publish(Event(EventType::KEY_SELECT));
+            publish(EventType::KEY_SELECT, sdlTimestamp);
             break;
         case SDLK_ESCAPE:
-            eventBus.publish(Event(EventType::KEY_BACK));
+            publish(EventType::KEY_BACK, sdlTimestamp);
+            break;
+        case SDLK_F3:
+            publish(EventType::TOGGLE_PROFILER_OVERLAY, sdlTimestamp);
             break;
         default:
             break;
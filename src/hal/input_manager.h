@@ -5,6 +5,8 @@
 
 namespace AOS {
 
+class EventRecorder;
+
 /**
  * InputManager - Handles input from keyboard/gamepad and converts to events
  *
@@ -12,12 +14,14 @@ namespace AOS {
  * - Poll SDL input events
  * - Map keyboard keys to OS events
  * - Map gamepad buttons to OS events (future)
- * - Publish input events to EventBus
+ * - Publish input events to EventBus, stamped with when SDL saw the
+ *   input (millisecond precision) on the event clock
  *
  * Desktop simulation mapping:
  * - Arrow keys -> KEY_UP/DOWN/LEFT/RIGHT
  * - Enter -> KEY_SELECT
  * - Escape -> KEY_BACK
+ * - F3 -> TOGGLE_PROFILER_OVERLAY
  *
  * On Raspberry Pi, this will also handle:
  * - GPIO buttons
@@ -31,13 +35,34 @@ public:
     // Poll and process input (called each frame)
     void pollInput();
 
+    // Sleep until an event is pending or timeoutMs passes; the event is
+    // left for pollInput(). Used when the OS skipped a frame and vsync
+    // isn't pacing the loop.
+    void waitForInput(int timeoutMs);
+
     // Check if quit was requested (window close, etc.)
     bool isQuitRequested() const { return quitRequested; }
 
+    // True once after the window was exposed/resized or render targets
+    // were reset, i.e. whatever was on screen can't be trusted
+    bool consumeRedrawRequest();
+
+    // True once after the window changed size
+    bool consumeSizeChange();
+
+    // Hand every published input event to a recorder (nullptr = off)
+    void setRecorder(EventRecorder* eventRecorder) { recorder = eventRecorder; }
+
 private:
     bool quitRequested;
+    bool redrawRequested;
+    bool sizeChanged;
+    EventRecorder* recorder;
+
+    void handleEvent(const SDL_Event& event);
+    void publish(EventType type, Uint32 sdlTimestamp);
 
-    void handleKeyDown(SDL_Keycode key);
+    void handleKeyDown(SDL_Keycode key, Uint32 sdlTimestamp);
     void handleKeyUp(SDL_Keycode key);
 };
 
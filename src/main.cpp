@@ -7,14 +7,93 @@
 #include "apps/flappy_app.h"
 #include <memory>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
 
 // Global pointer for apps to access AppManager
 // (In a more sophisticated system, this would be handled via dependency injection)
 AOS::AppManager* g_appManager = nullptr;
 
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --fullscreen          Use the whole display\n"
+              << "  --headless            Software rendering, no window, no vsync\n"
+              << "  --frames N            Exit after N frames\n"
+              << "  --dump-frames DIR     Save every presented frame to DIR as BMP\n"
+              << "  --trace FILE          Record a Chrome trace (Perfetto JSON) to FILE\n"
+              << "  --record FILE         Record input and frame timing to FILE\n"
+              << "  --replay FILE         Replay a recording headlessly, as fast as possible\n"
+              << "  --realtime            With --replay: keep the recorded frame timing\n"
+              << "  --frame-log FILE      Write per-frame phase times to FILE as CSV\n"
+              << "  --latency-marker      Flash a corner marker on each input (camera check)\n"
+              << "  --app-memory MB       Memory budget for suspended apps (default 64, 0 = none)\n"
+              << "  --usage-file FILE     App launch history for prewarming (default aos_usage.txt)\n"
+              << "  --help                Show this message" << std::endl;
+}
+
+// Returns false (after printing why) if the arguments don't make sense
+static bool parseArguments(int argc, char* argv[], AOS::LaunchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--fullscreen") == 0) {
+            options.fullscreen = true;
+        } else if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            options.maxFrames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--dump-frames") == 0 && hasValue) {
+            options.dumpFramesDir = argv[++i];
+        } else if (std::strcmp(arg, "--trace") == 0 && hasValue) {
+            options.traceFile = argv[++i];
+        } else if (std::strcmp(arg, "--record") == 0 && hasValue) {
+            options.recordFile = argv[++i];
+        } else if (std::strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayFile = argv[++i];
+        } else if (std::strcmp(arg, "--realtime") == 0) {
+            options.replayRealtime = true;
+        } else if (std::strcmp(arg, "--frame-log") == 0 && hasValue) {
+            options.frameLogFile = argv[++i];
+        } else if (std::strcmp(arg, "--latency-marker") == 0) {
+            options.latencyMarker = true;
+        } else if (std::strcmp(arg, "--app-memory") == 0 && hasValue) {
+            options.appMemoryBudget = (size_t)std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (std::strcmp(arg, "--usage-file") == 0 && hasValue) {
+            options.usageFile = argv[++i];
+        } else {
+            if (std::strcmp(arg, "--help") != 0) {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            }
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (!options.recordFile.empty() && !options.replayFile.empty()) {
+        std::cerr << "--record and --replay can't be combined" << std::endl;
+        return false;
+    }
+
+    if (!options.dumpFramesDir.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(options.dumpFramesDir, error);
+        if (error) {
+            std::cerr << "Cannot create " << options.dumpFramesDir << ": " << error.message() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    AOS::LaunchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
 
     std::cout << R"(
     ╔═══════════════════════════════════════╗
@@ -28,9 +107,8 @@ int main(int argc, char* argv[]) {
     // Create OS Core
     AOS::OSCore os;
 
-    // Initialize (desktop simulation mode: 1280x720 window)
-    bool fullscreen = false;
-    if (!os.initialize(1280, 720, fullscreen)) {
+    // Initialize (desktop simulation mode: 1280x720 window, unless headless)
+    if (!os.initialize(options)) {
         std::cerr << "Failed to initialize A-OS" << std::endl;
         return 1;
     }
@@ -42,14 +120,18 @@ int main(int argc, char* argv[]) {
     // Order matters: first app is Home
     std::cout << "Registering applications..." << std::endl;
 
-    g_appManager->registerApp(std::make_unique<AOS::HomeApp>());
-    g_appManager->registerApp(std::make_unique<AOS::SettingsApp>());
-    g_appManager->registerApp(std::make_unique<AOS::CameraApp>());
-    g_appManager->registerApp(std::make_unique<AOS::SysInfoApp>());
-    g_appManager->registerApp(std::make_unique<AOS::MediaApp>());
-    g_appManager->registerApp(std::make_unique<AOS::FlappyApp>());
+    // Apps are constructed when first launched
+    g_appManager->registerApp<AOS::HomeApp>();
+    g_appManager->registerApp<AOS::SettingsApp>();
+    g_appManager->registerApp<AOS::CameraApp>();
+    g_appManager->registerApp<AOS::SysInfoApp>();
+    g_appManager->registerApp<AOS::MediaApp>();
+    g_appManager->registerApp<AOS::FlappyApp>();
+
+    std::cout << g_appManager->getInstalledApps().size() << " applications registered." << std::endl;
 
-    std::cout << "6 applications registered." << std::endl;
+    // Get the usual apps ready while the home screen comes up
+    g_appManager->prewarmMostUsed(AOS::AppManager::BOOT_PREWARM_COUNT);
 
     // Launch home screen
     g_appManager->launchApp(0);
@@ -1,12 +1,27 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <vector>
 #include "event_bus.h"
 
 namespace AOS {
 
-// Forward declaration
+// Forward declarations
 class Renderer;
+struct Rect;
+
+/**
+ * AppInfo - What the OS knows about an app without constructing it
+ *
+ * Registered alongside the app's factory, so the home screen can list
+ * apps that haven't been launched yet. registerApp<T>() takes name
+ * from T::NAME, the same constant T::getName() returns.
+ */
+struct AppInfo {
+    std::string name;
+    std::string icon;       // Path to icon asset, may be empty
+};
 
 /**
  * App - Base class for all A-OS applications
@@ -16,26 +31,66 @@ class Renderer;
  *
  * Lifecycle flow:
  *   onStart() -> onResume() -> [running] -> onPause() -> onStop()
+ *
+ * An app that loses focus is normally suspended rather than stopped: it
+ * keeps its state and resources, and comes back with onResume() alone.
+ * onPause() should therefore stop timers and other foreground-only work;
+ * onStop() comes later, when AppManager evicts the app to stay within
+ * its memory budget (see getMemoryFootprint()) or at shutdown.
+ *
+ * onPrewarm() may run once ahead of an onStart(), on a JobSystem worker,
+ * when the OS expects the app to be launched soon. Do the slow part of
+ * starting there (loading, decoding, gathering data) into members that
+ * onStart()/onResume() pick up. Nothing else of the app runs meanwhile,
+ * and a launch waits for it to finish, but it must not use the renderer
+ * or other main-thread services. What it loads counts towards the memory
+ * budget; if the app isn't launched before that runs out, it is
+ * destroyed without ever being started, so keep what it loads in members
+ * that free themselves.
  */
 class App {
 public:
     virtual ~App() = default;
 
     // Lifecycle methods
+    virtual void onPrewarm() {}     // Launch is likely soon (worker thread)
     virtual void onStart() {}       // App is being launched
-    virtual void onPause() {}       // App is losing focus
+    virtual void onPause() {}       // App is losing focus (suspended)
     virtual void onResume() {}      // App is regaining focus
-    virtual void onStop() {}        // App is being closed
+    virtual void onStop() {}        // App is being closed (evicted)
 
     // Frame update (called every frame while app is active)
     virtual void update(float deltaTime) {}
 
+    // Fixed-step simulation (opt-in). Return a step in seconds and
+    // update() is always called with exactly that step: zero or more times
+    // per frame, as the elapsed time allows (see AppManager for the
+    // catch-up limit). 0 means one update() per frame with the real delta.
+    virtual float getFixedTimestep() const { return 0.0f; }
+
     // Rendering (called every frame while app is active)
     virtual void render(Renderer& renderer) {}
 
+    // Rendering for fixed-step apps. alpha (0..1) is how far the current
+    // time lies between the previous and the latest step, for drawing
+    // interpolated positions. By default it is ignored.
+    virtual void renderInterpolated(Renderer& renderer, float /*alpha*/) { render(renderer); }
+
+    // Damage reporting (called after update(), before render()).
+    // Return false if nothing on screen changed; the frame is then skipped
+    // entirely. Otherwise optionally append the changed regions - render()
+    // is then clipped to each of them in turn. No regions means redraw
+    // everything, which is also what the default does.
+    virtual bool collectDamage(std::vector<Rect>& /*regions*/) { return true; }
+
     // Event handling
     virtual void onEvent(const Event& event) {}
 
+    // Approximate bytes the app holds on to while suspended (surfaces,
+    // textures, buffers). Counted against AppManager's memory budget;
+    // 0 means too little to matter.
+    virtual size_t getMemoryFootprint() const { return 0; }
+
     // App metadata
     virtual std::string getName() const = 0;
     virtual std::string getIcon() const { return ""; }  // Path to icon asset
@@ -1,4 +1,8 @@
 #include "app_manager.h"
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 namespace AOS {
@@ -6,41 +10,54 @@ namespace AOS {
 AppManager::AppManager()
     : activeApp(nullptr)
     , homeAppIndex(0)
+    , memoryBudget(DEFAULT_MEMORY_BUDGET)
+    , coldLaunchCount(0)
+    , warmLaunchCount(0)
+    , evictionCount(0)
+    , prewarmCount(0)
+    , prewarmedLaunchCount(0)
+    , prewarmWaitCount(0)
+    , prewarmReleaseCount(0)
+    , stepAccumulator(0.0f)
+    , interpolationAlpha(1.0f)
+    , simulationSteps(0)
+    , droppedSteps(0)
 {
-    // Subscribe to all input events and forward to active app
-    auto& eventBus = EventBus::getInstance();
-
-    eventBus.subscribe(EventType::KEY_UP, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
-
-    eventBus.subscribe(EventType::KEY_DOWN, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
-
-    eventBus.subscribe(EventType::KEY_LEFT, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
+    // Forward all input events to the active app
+    const EventType inputEvents[] = {
+        EventType::KEY_UP, EventType::KEY_DOWN, EventType::KEY_LEFT,
+        EventType::KEY_RIGHT, EventType::KEY_SELECT, EventType::KEY_BACK
+    };
 
-    eventBus.subscribe(EventType::KEY_RIGHT, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
-
-    eventBus.subscribe(EventType::KEY_SELECT, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
-
-    eventBus.subscribe(EventType::KEY_BACK, [this](const Event& e) {
-        if (activeApp) activeApp->onEvent(e);
-    });
+    auto& eventBus = EventBus::getInstance();
+    for (EventType type : inputEvents) {
+        subscriptions.push_back(eventBus.subscribe(type, [this](const Event& e) {
+            if (activeApp) activeApp->onEvent(e);
+        }));
+    }
 }
 
 AppManager::~AppManager() {
+    // The bus outlives us; don't leave it holding this
+    auto& eventBus = EventBus::getInstance();
+    for (const auto& subscription : subscriptions) {
+        eventBus.unsubscribe(subscription);
+    }
 }
 
-void AppManager::registerApp(std::unique_ptr<App> app) {
-    appPointers.push_back(app.get());
-    apps.push_back(std::move(app));
+void AppManager::registerApp(AppInfo info, AppFactory factory) {
+    if (!factory) {
+        std::cerr << "App has no factory: " << info.name << std::endl;
+        return;
+    }
+    if (nameIndex.count(info.name)) {
+        std::cerr << "App already registered: " << info.name << std::endl;
+        return;
+    }
+
+    nameIndex.emplace(info.name, apps.size());
+    apps.push_back({ std::move(factory), nullptr, 0.0, JobSystem::JobHandle() });
+    appInfos.push_back(std::move(info));
 
     // First registered app is assumed to be Home
     if (apps.size() == 1) {
@@ -48,8 +65,8 @@ void AppManager::registerApp(std::unique_ptr<App> app) {
     }
 }
 
-const std::vector<App*>& AppManager::getInstalledApps() const {
-    return appPointers;
+const std::vector<AppInfo>& AppManager::getInstalledApps() const {
+    return appInfos;
 }
 
 void AppManager::launchApp(size_t index) {
@@ -58,36 +75,230 @@ void AppManager::launchApp(size_t index) {
         return;
     }
 
-    switchToApp(apps[index].get());
+    App* app = getOrCreateApp(index);
+    if (!app || app == activeApp) {
+        return;
+    }
+
+    if (index != homeAppIndex) {
+        usageStore.recordLaunch(appInfos[index].name);
+    }
+
+    // About to be started: its prewarm has to be done by then
+    if (!isSuspended(app)) {
+        finishPrewarm(index);
+    }
+    switchToApp(app);
 }
 
 void AppManager::launchAppByName(const std::string& name) {
-    for (size_t i = 0; i < apps.size(); ++i) {
-        if (apps[i]->getName() == name) {
-            launchApp(i);
-            return;
-        }
+    auto it = nameIndex.find(name);
+    if (it == nameIndex.end()) {
+        std::cerr << "App not found: " << name << std::endl;
+        return;
     }
 
-    std::cerr << "App not found: " << name << std::endl;
+    launchApp(it->second);
 }
 
 void AppManager::returnToHome() {
     if (homeAppIndex < apps.size()) {
-        switchToApp(apps[homeAppIndex].get());
+        launchApp(homeAppIndex);
     }
 }
 
+void AppManager::prewarmApp(size_t index) {
+    if (index >= apps.size() || apps[index].prewarmJob.isValid()) {
+        return;
+    }
+
+    // Make room first (earlier prewarms may have loaded since), then only
+    // prewarm if what it already holds fits
+    evictToBudget();
+    if (memoryBudget == 0) {
+        return;
+    }
+
+    App* app = getOrCreateApp(index);
+    if (!app || isStarted(app)) {
+        return;
+    }
+    if (getResidentMemory() + app->getMemoryFootprint() > memoryBudget) {
+        return;
+    }
+
+    AOS_TRACE_INSTANT("Prewarm app", "app", appInfos[index].name.c_str());
+    apps[index].prewarmJob = JobSystem::getInstance().submit([app]() { app->onPrewarm(); });
+    prewarmedApps.push_back(index);
+    prewarmCount++;
+}
+
+void AppManager::prewarmAppByName(const std::string& name) {
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end()) {
+        prewarmApp(it->second);
+    }
+}
+
+void AppManager::prewarmMostUsed(size_t count) {
+    for (const std::string& name : usageStore.getMostUsed(count)) {
+        prewarmAppByName(name);
+    }
+}
+
+bool AppManager::isStarted(const App* app) const {
+    return app == activeApp || isSuspended(app);
+}
+
+void AppManager::finishPrewarm(size_t index) {
+    JobSystem::JobHandle& job = apps[index].prewarmJob;
+    if (!job.isValid()) {
+        return;
+    }
+
+    JobSystem& jobs = JobSystem::getInstance();
+    if (jobs.isComplete(job)) {
+        prewarmedLaunchCount++;
+    } else {
+        AOS_TRACE_ZONE("Wait for prewarm", "app");
+        jobs.wait(job);
+        prewarmWaitCount++;
+    }
+
+    // Used up by this start; after an eviction it can be prewarmed again
+    job = JobSystem::JobHandle();
+    prewarmedApps.erase(std::remove(prewarmedApps.begin(), prewarmedApps.end(), index), prewarmedApps.end());
+}
+
+bool AppManager::isPrewarmDone(size_t index) const {
+    // Until then the worker owns the app, footprint included
+    return JobSystem::getInstance().isComplete(apps[index].prewarmJob);
+}
+
+App* AppManager::getOrCreateApp(size_t index) {
+    InstalledApp& installed = apps[index];
+    if (installed.instance) {
+        return installed.instance.get();
+    }
+
+    const std::string& name = appInfos[index].name;
+    {
+        AOS_TRACE_ZONE_DETAIL("Construct app", "app", name.c_str());
+        auto start = std::chrono::steady_clock::now();
+        installed.instance = installed.factory();
+        installed.constructionMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (!installed.instance) {
+        std::cerr << "App factory failed: " << name << std::endl;
+        return nullptr;
+    }
+
+    std::cout << "Constructed app: " << name << " (" << installed.constructionMs << " ms)" << std::endl;
+    return installed.instance.get();
+}
+
+bool AppManager::isConstructed(size_t index) const {
+    return index < apps.size() && apps[index].instance != nullptr;
+}
+
+double AppManager::getConstructionTimeMs(size_t index) const {
+    return index < apps.size() ? apps[index].constructionMs : 0.0;
+}
+
+void AppManager::shutdown() {
+    switchToApp(nullptr);
+}
+
+void AppManager::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    if (memoryBudget == 0) {
+        // Nothing stays in the background
+        for (App* app : suspendedApps) {
+            stopApp(app);
+            evictionCount++;
+        }
+        suspendedApps.clear();
+        return;
+    }
+    evictToBudget();
+}
+
+size_t AppManager::getResidentMemory() const {
+    size_t resident = activeApp ? activeApp->getMemoryFootprint() : 0;
+    for (const App* app : suspendedApps) {
+        resident += app->getMemoryFootprint();
+    }
+    for (size_t index : prewarmedApps) {
+        if (isPrewarmDone(index)) {
+            resident += apps[index].instance->getMemoryFootprint();
+        }
+    }
+    return resident;
+}
+
+bool AppManager::isSuspended(const App* app) const {
+    return std::find(suspendedApps.begin(), suspendedApps.end(), app) != suspendedApps.end();
+}
+
+AppManager::LaunchStats AppManager::getLaunchStats() const {
+    LaunchStats stats;
+    stats.coldLaunches = coldLaunchCount;
+    stats.warmLaunches = warmLaunchCount;
+    stats.evictions = evictionCount;
+    stats.prewarms = prewarmCount;
+    stats.prewarmedLaunches = prewarmedLaunchCount;
+    stats.prewarmWaits = prewarmWaitCount;
+    stats.prewarmsReleased = prewarmReleaseCount;
+    return stats;
+}
+
 void AppManager::update(float deltaTime) {
-    if (activeApp) {
+    if (!activeApp) {
+        return;
+    }
+
+    const float step = activeApp->getFixedTimestep();
+    if (step <= 0.0f) {
         activeApp->update(deltaTime);
+        interpolationAlpha = 1.0f;
+        return;
+    }
+
+    // A hitch (or a slow app launch) must not turn into a burst of steps
+    stepAccumulator += std::min(deltaTime, MAX_FRAME_TIME);
+
+    int steps = 0;
+    while (stepAccumulator >= step && steps < MAX_STEPS_PER_FRAME) {
+        activeApp->update(step);
+        stepAccumulator -= step;
+        steps++;
+    }
+    simulationSteps += steps;
+
+    if (stepAccumulator >= step) {
+        // Still behind after the catch-up limit: let the backlog go
+        uint64_t behind = (uint64_t)(stepAccumulator / step);
+        droppedSteps += behind;
+        stepAccumulator = std::fmod(stepAccumulator, step);
+        AOS_TRACE_INSTANT("Simulation steps dropped", "app", nullptr);
     }
+
+    interpolationAlpha = stepAccumulator / step;
 }
 
 void AppManager::render(Renderer& renderer) {
     if (activeApp) {
-        activeApp->render(renderer);
+        activeApp->renderInterpolated(renderer, interpolationAlpha);
+    }
+}
+
+bool AppManager::collectDamage(std::vector<Rect>& regions) {
+    if (activeApp) {
+        return activeApp->collectDamage(regions);
     }
+    return false;
 }
 
 void AppManager::switchToApp(App* newApp) {
@@ -95,19 +306,108 @@ void AppManager::switchToApp(App* newApp) {
         return;  // Already active
     }
 
-    // Pause current app
+    Tracer& tracer = Tracer::getInstance();
+    std::string transition;
+    if (tracer.isEnabled()) {
+        transition = (activeApp ? activeApp->getName() : std::string("none")) + " -> " +
+                     (newApp ? newApp->getName() : std::string("none"));
+        tracer.addInstant("App transition", "app", transition.c_str());
+    }
+    AOS_TRACE_ZONE_DETAIL("switchToApp", "app", transition.c_str());
+
+    // Pause current app, and keep it around unless we're shutting down
     if (activeApp) {
-        activeApp->onPause();
-        activeApp->onStop();
+        {
+            AOS_TRACE_ZONE("onPause", "app");
+            activeApp->onPause();
+        }
+        if (newApp && memoryBudget > 0) {
+            suspendedApps.push_back(activeApp);
+        } else {
+            stopApp(activeApp);
+        }
     }
 
-    // Start new app
     activeApp = newApp;
-    if (activeApp) {
+    stepAccumulator = 0.0f;
+    interpolationAlpha = 1.0f;
+
+    if (!activeApp) {
+        for (App* app : suspendedApps) {
+            stopApp(app);
+        }
+        suspendedApps.clear();
+        return;
+    }
+
+    // Resume a suspended app as it was, or start it from scratch
+    auto suspended = std::find(suspendedApps.begin(), suspendedApps.end(), activeApp);
+    if (suspended != suspendedApps.end()) {
+        suspendedApps.erase(suspended);
+        warmLaunchCount++;
+        std::cout << "Resuming app: " << activeApp->getName() << std::endl;
+    } else {
+        coldLaunchCount++;
         std::cout << "Launching app: " << activeApp->getName() << std::endl;
+        AOS_TRACE_ZONE("onStart", "app");
         activeApp->onStart();
+    }
+    {
+        AOS_TRACE_ZONE("onResume", "app");
         activeApp->onResume();
     }
+
+    evictToBudget();
+}
+
+void AppManager::stopApp(App* app) {
+    AOS_TRACE_ZONE("onStop", "app");
+    app->onStop();
+}
+
+void AppManager::evictToBudget() {
+    // Footprints change while apps run (and while suspended, as jobs
+    // complete), so they are asked afresh at every switch
+    size_t resident = getResidentMemory();
+
+    // Prewarmed apps were only a guess; they go before anything the user
+    // actually left in the background
+    auto prewarmed = prewarmedApps.begin();
+    while (resident > memoryBudget && prewarmed != prewarmedApps.end()) {
+        const size_t index = *prewarmed;
+        if (!isPrewarmDone(index)) {
+            ++prewarmed;
+            continue;
+        }
+        const size_t footprint = apps[index].instance->getMemoryFootprint();
+        if (footprint == 0) {
+            ++prewarmed;
+            continue;
+        }
+
+        prewarmed = prewarmedApps.erase(prewarmed);
+        resident -= std::min(resident, footprint);
+        std::cout << "Releasing prewarmed app: " << appInfos[index].name << std::endl;
+        apps[index].prewarmJob = JobSystem::JobHandle();
+        apps[index].instance.reset();
+        prewarmReleaseCount++;
+    }
+
+    auto it = suspendedApps.begin();
+    while (resident > memoryBudget && it != suspendedApps.end()) {
+        App* app = *it;
+        const size_t footprint = app->getMemoryFootprint();
+        if (footprint == 0) {
+            ++it;   // Stopping it wouldn't free anything
+            continue;
+        }
+
+        it = suspendedApps.erase(it);
+        resident -= std::min(resident, footprint);
+        std::cout << "Evicting app: " << app->getName() << std::endl;
+        stopApp(app);
+        evictionCount++;
+    }
 }
 
 } // namespace AOS
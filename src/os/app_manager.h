@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "app.h"
+#include "app_usage_store.h"
+#include "job_system.h"
 
 namespace AOS {
 
@@ -11,24 +16,81 @@ namespace AOS {
  * AppManager - Manages application lifecycle and switching
  *
  * Responsibilities:
- * - Register installed apps
+ * - Register installed apps (as factories, constructed on first launch)
  * - Launch and switch between apps
  * - Manage app lifecycle (start, pause, resume, stop)
  * - Only one app active (foreground) at a time
  *
  * This is the core of the "console experience" - apps don't overlap,
  * only one is visible and interactive at any time.
+ *
+ * Registering an app only stores its AppInfo and a factory; the app
+ * object is created the first time it is launched and then lives until
+ * the AppManager goes, so startup cost and memory grow with the apps
+ * actually used rather than the apps installed. Names are looked up
+ * through a hash index.
+ *
+ * An app that is probably about to be launched (the home screen focus
+ * rests on it, or it is among the most used at boot) can be prewarmed:
+ * it is constructed and its onPrewarm() runs on a job, so by the time it
+ * is launched only onStart()/onResume() are left. Launches are counted
+ * in an AppUsageStore that OSCore keeps on disk. Once its onPrewarm() has
+ * returned, an app that hasn't been launched yet counts towards the
+ * memory budget below. Such apps are the first to go when it is
+ * exceeded: never having started, they are simply destroyed, and
+ * constructed again if they are prewarmed or launched later. Nothing is
+ * prewarmed while the budget is already used up.
+ *
+ * Switching away from an app pauses it but keeps it in memory, so going
+ * back to it is just onResume(). Suspended apps are kept in least
+ * recently used order; after each switch and prewarm, unlaunched
+ * prewarmed apps and then the oldest suspended ones are let go until
+ * the footprint of everything in memory (getMemoryFootprint()) fits the
+ * memory budget again. The active app, and apps whose footprint is 0,
+ * are never evicted for the budget. A budget of 0 stops every app as
+ * soon as it leaves the screen.
+ *
+ * Apps with a fixed timestep are driven from an accumulator: each frame
+ * adds the elapsed time (clamped to MAX_FRAME_TIME) and runs whole steps,
+ * at most MAX_STEPS_PER_FRAME of them. Time beyond that is dropped, so an
+ * overloaded device runs the simulation slower instead of spending ever
+ * longer catching up.
  */
 class AppManager {
 public:
+    static constexpr float MAX_FRAME_TIME = 0.25f;
+    static constexpr int MAX_STEPS_PER_FRAME = 8;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+    static constexpr size_t BOOT_PREWARM_COUNT = 2;
+
+    struct LaunchStats {
+        uint64_t coldLaunches;      // onStart() + onResume()
+        uint64_t warmLaunches;      // Resumed from suspension
+        uint64_t evictions;         // Suspended apps stopped for the budget
+        uint64_t prewarms;          // onPrewarm() jobs submitted
+        uint64_t prewarmedLaunches; // Cold launches whose prewarm was done
+        uint64_t prewarmWaits;      // Cold launches that waited for it
+        uint64_t prewarmsReleased;  // Prewarmed apps destroyed unlaunched for the budget
+    };
+
+    using AppFactory = std::function<std::unique_ptr<App>()>;
+
     AppManager();
     ~AppManager();
 
-    // Register an app (called during OS initialization)
-    void registerApp(std::unique_ptr<App> app);
+    // Register an app (called during OS initialization). The factory
+    // runs on first launch. Names must be unique.
+    void registerApp(AppInfo info, AppFactory factory);
+
+    // T names itself with a static NAME constant, which its getName()
+    // returns too
+    template <typename T>
+    void registerApp(std::string icon = "") {
+        registerApp(AppInfo{ T::NAME, std::move(icon) }, []() { return std::make_unique<T>(); });
+    }
 
     // Get list of all installed apps (for home screen display)
-    const std::vector<App*>& getInstalledApps() const;
+    const std::vector<AppInfo>& getInstalledApps() const;
 
     // Launch an app by index
     void launchApp(size_t index);
@@ -39,6 +101,39 @@ public:
     // Return to home screen
     void returnToHome();
 
+    // Construct the app if needed and run its onPrewarm() on a job. Does
+    // nothing if it is running, suspended or already prewarmed, or if the
+    // memory budget has no room left.
+    void prewarmApp(size_t index);
+    void prewarmAppByName(const std::string& name);
+
+    // Prewarm the most launched apps according to the usage history
+    void prewarmMostUsed(size_t count);
+
+    AppUsageStore& getUsageStore() { return usageStore; }
+
+    // Pause and stop the active app and every suspended one (OS
+    // shutdown). Apps release their SDL resources in onStop(), so this
+    // runs before the renderer goes.
+    void shutdown();
+
+    // Bytes that the active and suspended apps may hold together.
+    // Lowering it evicts right away.
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const { return memoryBudget; }
+
+    // Combined footprint of the active and suspended apps, and of the
+    // prewarmed ones whose onPrewarm() has returned
+    size_t getResidentMemory() const;
+
+    bool isSuspended(const App* app) const;
+    LaunchStats getLaunchStats() const;
+
+    // Whether the app at index has been constructed, and how long its
+    // factory took (ms)
+    bool isConstructed(size_t index) const;
+    double getConstructionTimeMs(size_t index) const;
+
     // Get currently active app
     App* getActiveApp() const { return activeApp; }
 
@@ -51,13 +146,57 @@ public:
     // Render active app
     void render(Renderer& renderer);
 
+    // Fixed-step simulation steps run and skipped (catch-up limit hit)
+    uint64_t getSimulationSteps() const { return simulationSteps; }
+    uint64_t getDroppedSteps() const { return droppedSteps; }
+
+    // Ask the active app what changed since the last frame (see App)
+    bool collectDamage(std::vector<Rect>& regions);
+
 private:
-    std::vector<std::unique_ptr<App>> apps;
-    std::vector<App*> appPointers;  // Non-owning pointers for easy access
+    struct InstalledApp {
+        AppFactory factory;
+        std::unique_ptr<App> instance;      // Null until first launch
+        double constructionMs;
+        JobSystem::JobHandle prewarmJob;    // Valid until the next onStart()
+    };
+
+    std::vector<InstalledApp> apps;
+    std::vector<AppInfo> appInfos;          // Parallel to apps
+    std::unordered_map<std::string, size_t> nameIndex;
     App* activeApp;
     size_t homeAppIndex;
 
+    std::vector<EventBus::Subscription> subscriptions;
+
+    // Paused but still in memory, least recently used first
+    std::vector<App*> suspendedApps;
+    // Indices of apps prewarmed but not launched since, oldest first
+    std::vector<size_t> prewarmedApps;
+    size_t memoryBudget;
+    uint64_t coldLaunchCount;
+    uint64_t warmLaunchCount;
+    uint64_t evictionCount;
+    uint64_t prewarmCount;
+    uint64_t prewarmedLaunchCount;
+    uint64_t prewarmWaitCount;
+    uint64_t prewarmReleaseCount;
+
+    AppUsageStore usageStore;
+
+    // Fixed-step state for the active app
+    float stepAccumulator;
+    float interpolationAlpha;
+    uint64_t simulationSteps;
+    uint64_t droppedSteps;
+
+    App* getOrCreateApp(size_t index);
+    bool isStarted(const App* app) const;
+    void finishPrewarm(size_t index);
+    bool isPrewarmDone(size_t index) const;
     void switchToApp(App* newApp);
+    void stopApp(App* app);
+    void evictToBudget();
 };
 
 } // namespace AOS
@@ -0,0 +1,95 @@
+#include "app_usage_store.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace AOS {
+
+AppUsageStore::AppUsageStore()
+    : dirty(false)
+{
+}
+
+bool AppUsageStore::load(const std::string& usagePath) {
+    path = usagePath;
+    launchCounts.clear();
+    dirty = false;
+
+    std::ifstream input(path);
+    if (!input) {
+        return true;
+    }
+
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream fields(line);
+        uint32_t count = 0;
+        std::string name;
+        if (!(fields >> count) || !std::getline(fields >> std::ws, name) || name.empty()) {
+            continue;   // Skip anything we can't read
+        }
+        launchCounts[name] = std::min(count, MAX_COUNT);
+    }
+
+    std::cout << "AppUsageStore: " << launchCounts.size() << " apps in " << path << std::endl;
+    return true;
+}
+
+bool AppUsageStore::save() {
+    if (path.empty() || !dirty) {
+        return true;
+    }
+
+    std::ofstream output(path, std::ios::trunc);
+    if (!output) {
+        std::cerr << "AppUsageStore: cannot write " << path << std::endl;
+        return false;
+    }
+
+    for (const auto& entry : launchCounts) {
+        output << entry.second << " " << entry.first << "\n";
+    }
+    dirty = false;
+    return true;
+}
+
+void AppUsageStore::recordLaunch(const std::string& name) {
+    uint32_t& count = launchCounts[name];
+    count++;
+    dirty = true;
+
+    if (count >= MAX_COUNT) {
+        for (auto& entry : launchCounts) {
+            entry.second /= 2;
+        }
+    }
+}
+
+uint32_t AppUsageStore::getLaunchCount(const std::string& name) const {
+    auto it = launchCounts.find(name);
+    return it != launchCounts.end() ? it->second : 0;
+}
+
+std::vector<std::string> AppUsageStore::getMostUsed(size_t count) const {
+    std::vector<std::pair<uint32_t, std::string>> ranked;
+    ranked.reserve(launchCounts.size());
+    for (const auto& entry : launchCounts) {
+        if (entry.second > 0) {
+            ranked.emplace_back(entry.second, entry.first);
+        }
+    }
+
+    // Ties by name, so the order doesn't depend on the hash table
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < ranked.size() && i < count; ++i) {
+        names.push_back(ranked[i].second);
+    }
+    return names;
+}
+
+} // namespace AOS
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace AOS {
+
+/**
+ * AppUsageStore - How often each app gets launched, kept across runs
+ *
+ * A small text file with one "<count> <app name>" line per app. Once a
+ * count reaches MAX_COUNT all counts are halved, so the ranking follows
+ * recent habits instead of growing forever. AppManager records launches
+ * and uses the ranking to prewarm the likely apps at boot.
+ */
+class AppUsageStore {
+public:
+    static constexpr uint32_t MAX_COUNT = 1000;
+
+    AppUsageStore();
+
+    // A missing file is an empty history, not an error
+    bool load(const std::string& path);
+
+    // Write back to the loaded path (no-op if nothing was loaded or
+    // nothing changed)
+    bool save();
+
+    void recordLaunch(const std::string& name);
+    uint32_t getLaunchCount(const std::string& name) const;
+
+    // Up to count app names, most launched first
+    std::vector<std::string> getMostUsed(size_t count) const;
+
+private:
+    std::string path;
+    std::unordered_map<std::string, uint32_t> launchCounts;
+    bool dirty;
+};
+
+} // namespace AOS
@@ -0,0 +1,191 @@
+#include "coroutine.h"
+
+#ifdef AOS_COROUTINES
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <new>
+
+namespace AOS {
+
+CoroutineFramePool& CoroutineFramePool::getInstance() {
+    static CoroutineFramePool instance;
+    return instance;
+}
+
+CoroutineFramePool::CoroutineFramePool()
+    : freeLists()
+    , allocationCount(0)
+    , heapAllocationCount(0)
+    , cachedCount(0)
+{
+}
+
+CoroutineFramePool::~CoroutineFramePool() {
+    for (FreeBlock*& list : freeLists) {
+        while (list) {
+            FreeBlock* next = list->next;
+            ::operator delete(list);
+            list = next;
+        }
+    }
+}
+
+void* CoroutineFramePool::allocate(size_t size) {
+    allocationCount++;
+
+    if (size > MAX_POOLED_SIZE) {
+        heapAllocationCount++;
+        return ::operator new(size);
+    }
+
+    const size_t sizeClass = (size + SIZE_CLASS - 1) / SIZE_CLASS - 1;
+    if (FreeBlock* block = freeLists[sizeClass]) {
+        freeLists[sizeClass] = block->next;
+        cachedCount--;
+        return block;
+    }
+
+    heapAllocationCount++;
+    return ::operator new((sizeClass + 1) * SIZE_CLASS);
+}
+
+void CoroutineFramePool::deallocate(void* frame, size_t size) {
+    if (size > MAX_POOLED_SIZE) {
+        ::operator delete(frame);
+        return;
+    }
+
+    const size_t sizeClass = (size + SIZE_CLASS - 1) / SIZE_CLASS - 1;
+    FreeBlock* block = new (frame) FreeBlock{ freeLists[sizeClass] };
+    freeLists[sizeClass] = block;
+    cachedCount++;
+}
+
+CoroutineFramePool::Stats CoroutineFramePool::getStats() const {
+    Stats stats;
+    stats.allocations = allocationCount;
+    stats.heapAllocations = heapAllocationCount;
+    stats.cachedBlocks = cachedCount;
+    return stats;
+}
+
+void Task::promise_type::unhandled_exception() {
+    std::cerr << "Task: unhandled exception in coroutine" << std::endl;
+    std::terminate();
+}
+
+Task& Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        cancel();
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+void Task::cancel() {
+    // Destroying the frame runs the pending awaiter's destructor, which
+    // withdraws the timer, subscription or frame wait
+    if (handle) {
+        handle.destroy();
+        handle = nullptr;
+    }
+}
+
+CoroutineScheduler& CoroutineScheduler::getInstance() {
+    static CoroutineScheduler instance;
+    return instance;
+}
+
+void CoroutineScheduler::resumeFrame() {
+    if (waiting.empty()) {
+        return;
+    }
+
+    // Coroutines that wait again while resuming go into the fresh list
+    // and run next frame
+    resuming.swap(waiting);
+    for (size_t i = 0; i < resuming.size(); ++i) {
+        FrameAwaiter* awaiter = resuming[i];
+        if (awaiter) {
+            awaiter->queued = false;
+            awaiter->handle.resume();
+        }
+    }
+    resuming.clear();
+}
+
+void CoroutineScheduler::add(FrameAwaiter* awaiter) {
+    awaiter->queued = true;
+    waiting.push_back(awaiter);
+}
+
+void CoroutineScheduler::remove(FrameAwaiter* awaiter) {
+    // A cancelled Task can sit in either list, resumeFrame() may be
+    // walking the second one
+    for (auto* list : { &waiting, &resuming }) {
+        auto it = std::find(list->begin(), list->end(), awaiter);
+        if (it != list->end()) {
+            *it = nullptr;
+        }
+    }
+    awaiter->queued = false;
+}
+
+CoroutineScheduler::FrameAwaiter::~FrameAwaiter() {
+    if (queued) {
+        CoroutineScheduler::getInstance().remove(this);
+    }
+}
+
+void CoroutineScheduler::FrameAwaiter::await_suspend(std::coroutine_handle<> coroutine) {
+    handle = coroutine;
+    CoroutineScheduler::getInstance().add(this);
+}
+
+void DelayAwaiter::await_suspend(std::coroutine_handle<> coroutine) {
+    timer = TimerService::getInstance().schedule(delayMs, [coroutine]() { coroutine.resume(); });
+}
+
+EventAwaiter::~EventAwaiter() {
+    if (subscription.id != 0) {
+        EventBus::getInstance().unsubscribe(subscription);
+    }
+}
+
+void EventAwaiter::await_suspend(std::coroutine_handle<> coroutine) {
+    handle = coroutine;
+    subscription = EventBus::getInstance().subscribe(type, [this](const Event& received) {
+        // Resuming may finish the coroutine and destroy this awaiter, so
+        // it comes last
+        std::coroutine_handle<> waiter = handle;
+        event = received;
+        EventBus::getInstance().unsubscribe(subscription);
+        subscription.id = 0;
+        waiter.resume();
+    });
+}
+
+JobAwaiter::~JobAwaiter() {
+    if (resumer) {
+        resumer->handle = nullptr;
+    }
+}
+
+void JobAwaiter::await_suspend(std::coroutine_handle<> coroutine) {
+    resumer = std::make_shared<Resumer>(Resumer{ coroutine });
+    std::shared_ptr<Resumer> pending = resumer;
+    JobSystem::getInstance().submit(std::move(work), [pending]() {
+        if (pending->handle) {
+            std::coroutine_handle<> coroutine = pending->handle;
+            pending->handle = nullptr;
+            coroutine.resume();
+        }
+    });
+}
+
+} // namespace AOS
+
+#endif // AOS_COROUTINES
@@ -0,0 +1,246 @@
+#pragma once
+
+// Opt-in: configure with -DAOS_ENABLE_COROUTINES=ON (builds as C++20)
+#ifdef AOS_COROUTINES
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "event_bus.h"
+#include "job_system.h"
+#include "timer_service.h"
+
+namespace AOS {
+
+/**
+ * CoroutineFramePool - Recycles coroutine frames
+ *
+ * Task frames are allocated here instead of with the global operator
+ * new. Sizes are rounded up to SIZE_CLASS bytes and freed frames go on a
+ * per-class free list, so once an animation's coroutines have run once
+ * their frames are reused and steady-state code doesn't touch the heap.
+ * Frames above MAX_POOLED_SIZE go straight to the heap. Main thread only,
+ * like the coroutines themselves.
+ */
+class CoroutineFramePool {
+public:
+    static constexpr size_t SIZE_CLASS = 64;
+    static constexpr size_t MAX_POOLED_SIZE = 4096;
+
+    struct Stats {
+        uint64_t allocations;
+        uint64_t heapAllocations;   // New blocks and oversized frames
+        size_t cachedBlocks;        // Free, ready for reuse
+    };
+
+    static CoroutineFramePool& getInstance();
+
+    void* allocate(size_t size);
+    void deallocate(void* frame, size_t size);
+
+    Stats getStats() const;
+
+private:
+    CoroutineFramePool();
+    ~CoroutineFramePool();
+
+    // Non-copyable
+    CoroutineFramePool(const CoroutineFramePool&) = delete;
+    CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+    static constexpr size_t CLASS_COUNT = MAX_POOLED_SIZE / SIZE_CLASS;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::array<FreeBlock*, CLASS_COUNT> freeLists;
+    uint64_t allocationCount;
+    uint64_t heapAllocationCount;
+    size_t cachedCount;
+};
+
+/**
+ * Task - A coroutine for app logic that spans frames
+ *
+ * Write a sequence (flash, wait, fade, wait for a key) as straight-line
+ * code instead of a state machine ticked from update():
+ *
+ *     Task CameraApp::flash() {
+ *         capturing = true;
+ *         co_await delay(300);
+ *         capturing = false;
+ *     }
+ *
+ * A Task starts running as soon as it is called and suspends at each
+ * co_await on one of the awaitables below. The Task object owns the
+ * coroutine: destroying it (or cancel()) ends the coroutine wherever it
+ * is suspended and withdraws whatever it was waiting on, so apps keep
+ * their Tasks as members and cancel them in onStop().
+ *
+ * Everything resumes on the main thread. There are no exceptions in A-OS;
+ * one escaping a Task terminates.
+ */
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }   // The Task frees the frame
+        void return_void() {}
+        void unhandled_exception();
+
+        static void* operator new(size_t size) { return CoroutineFramePool::getInstance().allocate(size); }
+        static void operator delete(void* frame, size_t size) {
+            CoroutineFramePool::getInstance().deallocate(frame, size);
+        }
+    };
+
+    Task() = default;
+    ~Task() { cancel(); }
+
+    Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Task& operator=(Task&& other) noexcept;
+
+    // Non-copyable
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    // Finished (or never started)
+    bool isDone() const { return !handle || handle.done(); }
+
+    // Stop the coroutine where it is suspended
+    void cancel();
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * CoroutineScheduler - Resumes coroutines waiting for the next frame
+ *
+ * OSCore calls resumeFrame() once per frame, before the active app's
+ * update(). Coroutines that wait again from there resume a frame later.
+ */
+class CoroutineScheduler {
+public:
+    class FrameAwaiter;
+
+    static CoroutineScheduler& getInstance();
+
+    void resumeFrame();
+
+    size_t getWaitingCount() const { return waiting.size(); }
+
+private:
+    CoroutineScheduler() = default;
+
+    // Non-copyable
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    friend class FrameAwaiter;
+
+    std::vector<FrameAwaiter*> waiting;
+    std::vector<FrameAwaiter*> resuming;
+
+    void add(FrameAwaiter* awaiter);
+    void remove(FrameAwaiter* awaiter);
+};
+
+// co_await nextFrame(): resume at the start of the next frame
+class CoroutineScheduler::FrameAwaiter {
+public:
+    FrameAwaiter() : queued(false) {}
+    ~FrameAwaiter();
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    void await_resume() {}
+
+private:
+    friend class CoroutineScheduler;
+
+    std::coroutine_handle<> handle;
+    bool queued;
+};
+
+inline CoroutineScheduler::FrameAwaiter nextFrame() {
+    return CoroutineScheduler::FrameAwaiter();
+}
+
+// co_await delay(ms): resume after ms on the TimerService clock
+class DelayAwaiter {
+public:
+    explicit DelayAwaiter(uint32_t delayMs) : delayMs(delayMs), timer() {}
+    ~DelayAwaiter() { TimerService::getInstance().cancel(timer); }
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    void await_resume() {}
+
+private:
+    uint32_t delayMs;
+    TimerService::TimerHandle timer;
+};
+
+inline DelayAwaiter delay(uint32_t delayMs) {
+    return DelayAwaiter(delayMs);
+}
+
+// Event event = co_await nextEvent(type): resume when an event of that
+// type is dispatched, from inside the dispatch
+class EventAwaiter {
+public:
+    explicit EventAwaiter(EventType type) : type(type), subscription{ type, 0 } {}
+    ~EventAwaiter();
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    Event await_resume() const { return event; }
+
+private:
+    EventType type;
+    EventBus::Subscription subscription;
+    std::coroutine_handle<> handle;
+    Event event;
+};
+
+inline EventAwaiter nextEvent(EventType type) {
+    return EventAwaiter(type);
+}
+
+// co_await runJob(work): run work on the JobSystem, resume on the main
+// thread once it (and its children) finished
+class JobAwaiter {
+public:
+    explicit JobAwaiter(JobSystem::JobFunction work) : work(std::move(work)) {}
+    ~JobAwaiter();
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    void await_resume() {}
+
+private:
+    // Shared with the continuation, which may outlive a cancelled Task
+    struct Resumer {
+        std::coroutine_handle<> handle;
+    };
+
+    JobSystem::JobFunction work;
+    std::shared_ptr<Resumer> resumer;
+};
+
+inline JobAwaiter runJob(JobSystem::JobFunction work) {
+    return JobAwaiter(std::move(work));
+}
+
+} // namespace AOS
+
+#endif // AOS_COROUTINES
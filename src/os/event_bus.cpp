@@ -1,41 +1,323 @@
 #include "event_bus.h"
+#include "tracer.h"
+#include <algorithm>
+#include <type_traits>
 
 namespace AOS {
 
+const char* getEventTypeName(EventType type) {
+    switch (type) {
+        case EventType::SYSTEM_STARTUP:           return "SYSTEM_STARTUP";
+        case EventType::SYSTEM_SHUTDOWN:          return "SYSTEM_SHUTDOWN";
+        case EventType::KEY_UP:                   return "KEY_UP";
+        case EventType::KEY_DOWN:                 return "KEY_DOWN";
+        case EventType::KEY_LEFT:                 return "KEY_LEFT";
+        case EventType::KEY_RIGHT:                return "KEY_RIGHT";
+        case EventType::KEY_SELECT:               return "KEY_SELECT";
+        case EventType::KEY_BACK:                 return "KEY_BACK";
+        case EventType::VOICE_WAKE:               return "VOICE_WAKE";
+        case EventType::VOICE_PARTIAL:            return "VOICE_PARTIAL";
+        case EventType::VOICE_FINAL:              return "VOICE_FINAL";
+        case EventType::VOICE_COMMAND:            return "VOICE_COMMAND";
+        case EventType::APP_STARTED:              return "APP_STARTED";
+        case EventType::APP_PAUSED:               return "APP_PAUSED";
+        case EventType::APP_RESUMED:              return "APP_RESUMED";
+        case EventType::APP_STOPPED:              return "APP_STOPPED";
+        case EventType::TOGGLE_PROFILER_OVERLAY:  return "TOGGLE_PROFILER_OVERLAY";
+        case EventType::CUSTOM:                   return "CUSTOM";
+    }
+    return "UNKNOWN";
+}
+
+const char* getEventPriorityName(EventPriority priority) {
+    switch (priority) {
+        case EventPriority::High:   return "high";
+        case EventPriority::Normal: return "normal";
+        case EventPriority::Low:    return "low";
+    }
+    return "unknown";
+}
+
+static EventPriority getDefaultPriority(EventType type) {
+    switch (type) {
+        case EventType::SYSTEM_STARTUP:
+        case EventType::SYSTEM_SHUTDOWN:
+        case EventType::APP_STARTED:
+        case EventType::APP_PAUSED:
+        case EventType::APP_RESUMED:
+        case EventType::APP_STOPPED:
+            return EventPriority::High;
+        case EventType::VOICE_PARTIAL:
+            return EventPriority::Low;
+        default:
+            return EventPriority::Normal;
+    }
+}
+
+static_assert(std::is_trivially_copyable<Event>::value, "Event must stay trivially copyable");
+static_assert(sizeof(Event) == 128, "Event should stay two cache lines; resize EventPayload::CAPACITY");
+
+void EventPayload::assign(std::string_view value) {
+    size_t size = value.size();
+    truncated = size > CAPACITY;
+    if (truncated) {
+        // Don't split a multi-byte character
+        size = CAPACITY;
+        while (size > 0 && (static_cast<unsigned char>(value[size]) & 0xC0) == 0x80) {
+            size--;
+        }
+    }
+
+    value.copy(text, size);
+    text[size] = '\0';
+    length = static_cast<uint8_t>(size);
+}
+
 EventBus& EventBus::getInstance() {
     static EventBus instance;
     return instance;
 }
 
-void EventBus::subscribe(EventType type, EventHandler handler) {
-    subscribers[type].push_back(handler);
+EventBus::Lane::Lane(size_t capacity)
+    : queue(capacity)
+    , published(0)
+    , dropped(0)
+    , dispatched(0)
+    , coalesced(0)
+    , highWaterMark(0)
+    , totalLatencyNs(0)
+    , maxLatencyNs(0)
+{
+}
+
+EventBus::EventBus()
+    : lanes{ { Lane(HIGH_QUEUE_CAPACITY), Lane(QUEUE_CAPACITY), Lane(QUEUE_CAPACITY) } }
+    , nextSubscriptionId(1)
+    , dispatchDepth(0)
+    , needsCompaction(false)
+    , overflowPolicy(OverflowPolicy::DropNewest)
+    , consumerThread(std::this_thread::get_id())
+    , budgetUs(DEFAULT_BUDGET_US)
+    , truncatedCount(0)
+    , deferredFrames(0)
+{
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i) {
+        EventType type = static_cast<EventType>(i);
+        typePriority[i].store(static_cast<uint8_t>(getDefaultPriority(type)), std::memory_order_relaxed);
+        typeCoalescing[i].store(type == EventType::VOICE_PARTIAL, std::memory_order_relaxed);
+        typeSequence[i].store(0, std::memory_order_relaxed);
+        typeLatestQueued[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+EventBus::Subscription EventBus::subscribe(EventType type, EventHandler handler) {
+    Subscription subscription = { type, nextSubscriptionId++ };
+    handlers[static_cast<size_t>(type)].push_back({ subscription.id, handler });
+    return subscription;
+}
+
+bool EventBus::unsubscribe(const Subscription& subscription) {
+    std::vector<HandlerEntry>& list = handlers[static_cast<size_t>(subscription.type)];
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i].id != subscription.id || !list[i].handler) {
+            continue;
+        }
+
+        // Mid-dispatch the loop is walking this list; erase afterwards
+        if (dispatchDepth > 0) {
+            list[i].handler = EventHandler();
+            needsCompaction = true;
+        } else {
+            list.erase(list.begin() + i);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool EventBus::publish(const Event& event) {
+    if (event.payload.wasTruncated()) {
+        truncatedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const size_t typeIndex = static_cast<size_t>(event.type);
+    Lane& lane = lanes[typePriority[typeIndex].load(std::memory_order_relaxed)];
+
+    QueuedEvent queued;
+    queued.event = event;
+    queued.publishTimeNs = getEventClockNs();
+    if (queued.event.timestamp == 0) {
+        queued.event.timestamp = queued.publishTimeNs;
+    }
+    queued.coalescing = typeCoalescing[typeIndex].load(std::memory_order_relaxed);
+    queued.sequence = queued.coalescing
+        ? typeSequence[typeIndex].fetch_add(1, std::memory_order_relaxed) + 1
+        : 0;
+
+    while (!lane.queue.tryPush(queued)) {
+        // Waiting on the main thread would wait on ourselves
+        if (overflowPolicy.load(std::memory_order_relaxed) != OverflowPolicy::SpinUntilFree ||
+            std::this_thread::get_id() == consumerThread.load(std::memory_order_relaxed)) {
+            lane.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    // Only now does it supersede the ones already queued; a dropped
+    // event must not make them stale
+    if (queued.coalescing) {
+        markQueued(typeIndex, queued.sequence);
+    }
+
+    lane.published.fetch_add(1, std::memory_order_relaxed);
+    return true;
 }
 
-void EventBus::publish(const Event& event) {
-    eventQueue.push(event);
+void EventBus::markQueued(size_t typeIndex, uint32_t sequence) {
+    // Producers can finish out of order; keep the newest (wrap-safe)
+    std::atomic<uint32_t>& latest = typeLatestQueued[typeIndex];
+    uint32_t current = latest.load(std::memory_order_relaxed);
+    while ((int32_t)(sequence - current) > 0 &&
+           !latest.compare_exchange_weak(current, sequence, std::memory_order_relaxed)) {
+    }
 }
 
 void EventBus::processEvents() {
-    // Process all queued events
-    while (!eventQueue.empty()) {
-        Event event = eventQueue.front();
-        eventQueue.pop();
-
-        // Notify all subscribers of this event type
-        auto it = subscribers.find(event.type);
-        if (it != subscribers.end()) {
-            for (auto& handler : it->second) {
-                handler(event);
+    consumerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    for (Lane& lane : lanes) {
+        lane.highWaterMark = std::max(lane.highWaterMark, lane.queue.size());
+    }
+
+    Lane& high = lanes[static_cast<size_t>(EventPriority::High)];
+    Lane& normal = lanes[static_cast<size_t>(EventPriority::Normal)];
+    Lane& low = lanes[static_cast<size_t>(EventPriority::Low)];
+    const int64_t deadlineNs = budgetUs > 0 ? getEventClockNs() + budgetUs * 1000 : 0;
+
+    // One event at a time so High events published by handlers (or other
+    // threads) jump ahead of whatever is still waiting in the lower lanes
+    for (;;) {
+        if (dispatchNext(high)) {
+            continue;
+        }
+        if (deadlineNs != 0 && getEventClockNs() >= deadlineNs) {
+            if (normal.queue.size() > 0 || low.queue.size() > 0) {
+                deferredFrames++;
             }
+            break;
+        }
+        if (!dispatchNext(normal) && !dispatchNext(low)) {
+            break;
         }
     }
+
+    if (needsCompaction && dispatchDepth == 0) {
+        compactHandlers();
+    }
+}
+
+bool EventBus::dispatchNext(Lane& lane) {
+    return lane.queue.tryConsume([this, &lane](const QueuedEvent& queued) {
+        // A newer event of this type is queued behind; it supersedes this
+        // one. (If this is the newest but its producer hasn't marked it
+        // yet, it is simply delivered.)
+        const size_t typeIndex = static_cast<size_t>(queued.event.type);
+        const uint32_t latest = typeLatestQueued[typeIndex].load(std::memory_order_relaxed);
+        if (queued.coalescing && (int32_t)(latest - queued.sequence) > 0) {
+            lane.coalesced++;
+            return;
+        }
+
+        const int64_t latencyNs = getEventClockNs() - queued.publishTimeNs;
+        lane.totalLatencyNs += latencyNs;
+        lane.maxLatencyNs = std::max(lane.maxLatencyNs, latencyNs);
+        lane.dispatched++;
+        dispatch(queued.event);
+    });
 }
 
 void EventBus::clear() {
-    while (!eventQueue.empty()) {
-        eventQueue.pop();
+    for (Lane& lane : lanes) {
+        while (lane.queue.tryConsume([](const QueuedEvent&) {})) {
+        }
     }
-    subscribers.clear();
+    for (auto& list : handlers) {
+        if (dispatchDepth > 0) {
+            for (auto& entry : list) {
+                entry.handler = EventHandler();
+            }
+            needsCompaction = true;
+        } else {
+            list.clear();
+        }
+    }
+}
+
+void EventBus::dispatch(const Event& event) {
+    AOS_TRACE_ZONE_DETAIL("dispatch", "event", getEventTypeName(event.type));
+
+    std::vector<HandlerEntry>& list = handlers[static_cast<size_t>(event.type)];
+
+    // Handlers may subscribe (growing the list) or unsubscribe (emptying
+    // entries), so walk by index over the entries present at the start
+    // and call a copy of each handler
+    dispatchDepth++;
+    const size_t count = list.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (list[i].handler) {
+            EventHandler handler = list[i].handler;
+            handler(event);
+        }
+    }
+    dispatchDepth--;
+}
+
+void EventBus::compactHandlers() {
+    for (auto& list : handlers) {
+        list.erase(std::remove_if(list.begin(), list.end(),
+                                  [](const HandlerEntry& entry) { return !entry.handler; }),
+                   list.end());
+    }
+    needsCompaction = false;
+}
+
+void EventBus::setPriority(EventType type, EventPriority priority) {
+    typePriority[static_cast<size_t>(type)].store(static_cast<uint8_t>(priority), std::memory_order_relaxed);
+}
+
+void EventBus::setCoalescing(EventType type, bool enabled) {
+    typeCoalescing[static_cast<size_t>(type)].store(enabled, std::memory_order_relaxed);
+}
+
+EventPriority EventBus::getPriority(EventType type) const {
+    return static_cast<EventPriority>(typePriority[static_cast<size_t>(type)].load(std::memory_order_relaxed));
+}
+
+EventBus::Stats EventBus::getStats() const {
+    Stats stats = {};
+    for (const Lane& lane : lanes) {
+        stats.published += lane.published.load(std::memory_order_relaxed);
+        stats.dropped += lane.dropped.load(std::memory_order_relaxed);
+        stats.dispatched += lane.dispatched;
+        stats.coalesced += lane.coalesced;
+    }
+    stats.truncatedPayloads = truncatedCount.load(std::memory_order_relaxed);
+    stats.deferredFrames = deferredFrames;
+    return stats;
+}
+
+EventBus::LaneStats EventBus::getLaneStats(EventPriority priority) const {
+    const Lane& lane = lanes[static_cast<size_t>(priority)];
+    LaneStats stats;
+    stats.published = lane.published.load(std::memory_order_relaxed);
+    stats.dropped = lane.dropped.load(std::memory_order_relaxed);
+    stats.dispatched = lane.dispatched;
+    stats.coalesced = lane.coalesced;
+    stats.depth = lane.queue.size();
+    stats.highWaterMark = lane.highWaterMark;
+    stats.averageLatencyUs = lane.dispatched > 0 ? lane.totalLatencyNs / 1000.0 / lane.dispatched : 0.0;
+    stats.maxLatencyUs = lane.maxLatencyNs / 1000.0;
+    return stats;
 }
 
 } // namespace AOS
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
-#include <functional>
-#include <queue>
-#include <map>
+#include <string_view>
+#include <thread>
 #include <vector>
+#include "event_delegate.h"
+#include "mpsc_queue.h"
 
 namespace AOS {
 
@@ -37,23 +42,90 @@ enum class EventType {
     APP_RESUMED,
     APP_STOPPED,
 
+    // Diagnostics
+    TOGGLE_PROFILER_OVERLAY,   // F3
+
     // Custom app events
-    CUSTOM
+    CUSTOM          // Must stay last (see EVENT_TYPE_COUNT)
+};
+
+constexpr size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::CUSTOM) + 1;
+
+// Printable name of an event type (for logs and traces)
+const char* getEventTypeName(EventType type);
+
+// The clock event timestamps are on: monotonic nanoseconds
+inline int64_t getEventClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * EventPayload - Fixed-capacity text stored inside the Event
+ *
+ * Keeps Event trivially copyable (128 bytes), so creating, publishing
+ * and dispatching an event never touches the heap. Text longer than
+ * CAPACITY bytes is cut at a UTF-8 character boundary and flagged;
+ * anything bigger than a voice phrase or command belongs elsewhere, with
+ * a reference to it in data_int.
+ */
+class EventPayload {
+public:
+    static constexpr size_t CAPACITY = 109;
+
+    EventPayload() : text(), length(0), truncated(false) {}
+    EventPayload(std::string_view value) { assign(value); }
+
+    void assign(std::string_view value);
+
+    std::string_view view() const { return std::string_view(text, length); }
+    const char* c_str() const { return text; }
+    std::string str() const { return std::string(text, length); }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    bool wasTruncated() const { return truncated; }
+
+    bool operator==(std::string_view other) const { return view() == other; }
+    bool operator!=(std::string_view other) const { return view() != other; }
+
+private:
+    char text[CAPACITY + 1];    // NUL-terminated
+    uint8_t length;
+    bool truncated;
 };
 
 /**
  * Event structure
  * Unified event format for all OS communications
+ *
+ * timestamp is when the event originated on the getEventClockNs() clock:
+ * input sources set it to when the hardware reported the input, and
+ * publish() fills it in for everything else.
  */
 struct Event {
     EventType type;
-    std::string payload;    // Optional data (e.g., voice text, command params)
+    EventPayload payload;   // Optional data (e.g., voice text, command params)
     int data_int;          // Optional numeric data
+    int64_t timestamp;     // Origin time in ns, 0 = stamped when published
 
-    Event(EventType t, const std::string& p = "", int d = 0)
-        : type(t), payload(p), data_int(d) {}
+    Event() : type(EventType::CUSTOM), data_int(0), timestamp(0) {}
+    Event(EventType t, std::string_view p = std::string_view(), int d = 0)
+        : type(t), payload(p), data_int(d), timestamp(0) {}
 };
 
+/**
+ * Event priority lanes (see EventBus)
+ */
+enum class EventPriority : uint8_t {
+    High,       // System and app lifecycle: never deferred
+    Normal,     // Input, voice results, app events
+    Low         // High-volume streams such as VOICE_PARTIAL
+};
+
+constexpr size_t EVENT_PRIORITY_COUNT = 3;
+
+const char* getEventPriorityName(EventPriority priority);
+
 /**
  * EventBus - Central pub/sub system for OS-wide communication
  *
@@ -61,35 +133,157 @@ struct Event {
  * - Input devices publish events
  * - Apps subscribe to events they care about
  * - System components broadcast state changes
+ *
+ * publish() may be called from any thread (audio, voice, camera, GPIO
+ * producers): events go into bounded lock-free MPSC rings that the main
+ * thread drains in processEvents(). Publishing never locks or allocates.
+ * subscribe(), processEvents() and clear() belong to the main thread.
+ *
+ * Each event type maps to a priority lane with its own ring. The main
+ * thread always empties the High lane first, then takes Normal and Low
+ * events while the per-frame processing budget lasts; the rest waits for
+ * the next frame, so a flood of input or voice events can't hold up
+ * SYSTEM_SHUTDOWN or blow the frame deadline. High events are dispatched
+ * even over budget.
+ *
+ * Coalescing types (opt-in, VOICE_PARTIAL by default) only deliver the
+ * latest event: an older one still queued when a newer one of the same
+ * type has been published is skipped.
+ *
+ * When a lane is full the OverflowPolicy decides: drop the new event
+ * (the default; publish() returns false) or spin until the main thread
+ * makes room. Spinning is only for producers that must not lose events
+ * and can afford to wait; on the main thread it would never end, so
+ * there it drops too. Every drop is counted.
+ *
+ * Handlers live in a flat array indexed by EventType and are
+ * EventDelegates, so dispatch is an index, a loop and an indirect call
+ * per handler, with each event read in place from its ring.
  */
 class EventBus {
 public:
-    using EventHandler = std::function<void(const Event&)>;
+    using EventHandler = EventDelegate;
+
+    // Returned by subscribe(); pass to unsubscribe() to remove the handler
+    struct Subscription {
+        EventType type;
+        uint32_t id;        // 0 = invalid
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 1024;        // Normal and Low lanes
+    static constexpr size_t HIGH_QUEUE_CAPACITY = 256;
+    static constexpr int64_t DEFAULT_BUDGET_US = 4000;    // A quarter of a 60 Hz frame
+
+    enum class OverflowPolicy {
+        DropNewest,
+        SpinUntilFree
+    };
+
+    struct Stats {
+        uint64_t published;
+        uint64_t dropped;
+        uint64_t dispatched;
+        uint64_t coalesced;
+        uint64_t truncatedPayloads;
+        uint64_t deferredFrames;    // processEvents() calls that ran out of budget
+    };
+
+    struct LaneStats {
+        uint64_t published;
+        uint64_t dropped;
+        uint64_t dispatched;
+        uint64_t coalesced;
+        size_t depth;               // Queued right now
+        size_t highWaterMark;       // Deepest seen at the start of a drain
+        double averageLatencyUs;    // publish() to dispatch
+        double maxLatencyUs;
+    };
 
     static EventBus& getInstance();
 
-    // Subscribe to specific event type
-    void subscribe(EventType type, EventHandler handler);
+    // Subscribe to specific event type. Handlers added while an event is
+    // being dispatched first see the next event.
+    Subscription subscribe(EventType type, EventHandler handler);
+
+    // Remove a handler (safe from inside a handler). False if unknown.
+    bool unsubscribe(const Subscription& subscription);
 
-    // Publish an event (queued for next update cycle)
-    void publish(const Event& event);
+    // Publish an event (queued for next update cycle). Thread-safe.
+    // Returns false if it was dropped because its lane was full.
+    bool publish(const Event& event);
 
-    // Process queued events (called each frame)
+    // Process queued events (called each frame), within the budget
     void processEvents();
 
     // Clear all subscribers and events
     void clear();
 
+    // Configuration (set up before producer threads start publishing)
+    void setOverflowPolicy(OverflowPolicy policy) { overflowPolicy.store(policy, std::memory_order_relaxed); }
+    void setPriority(EventType type, EventPriority priority);
+    void setCoalescing(EventType type, bool enabled);
+    void setProcessingBudget(int64_t microseconds) { budgetUs = microseconds; }   // 0 = unlimited
+
+    EventPriority getPriority(EventType type) const;
+
+    Stats getStats() const;
+    LaneStats getLaneStats(EventPriority priority) const;
+
 private:
-    EventBus() = default;
+    EventBus();
     ~EventBus() = default;
 
     // Non-copyable
     EventBus(const EventBus&) = delete;
     EventBus& operator=(const EventBus&) = delete;
 
-    std::queue<Event> eventQueue;
-    std::map<EventType, std::vector<EventHandler>> subscribers;
+    struct HandlerEntry {
+        uint32_t id;
+        EventHandler handler;   // Empty once unsubscribed mid-dispatch
+    };
+
+    struct QueuedEvent {
+        Event event;
+        int64_t publishTimeNs;
+        uint32_t sequence;      // Per-type publish order, for coalescing
+        bool coalescing;
+    };
+
+    struct Lane {
+        explicit Lane(size_t capacity);
+
+        MpscQueue<QueuedEvent> queue;
+        std::atomic<uint64_t> published;
+        std::atomic<uint64_t> dropped;
+        uint64_t dispatched;
+        uint64_t coalesced;
+        size_t highWaterMark;
+        int64_t totalLatencyNs;
+        int64_t maxLatencyNs;
+    };
+
+    std::array<Lane, EVENT_PRIORITY_COUNT> lanes;
+    std::array<std::atomic<uint8_t>, EVENT_TYPE_COUNT> typePriority;
+    std::array<std::atomic<bool>, EVENT_TYPE_COUNT> typeCoalescing;
+    std::array<std::atomic<uint32_t>, EVENT_TYPE_COUNT> typeSequence;
+    std::array<std::atomic<uint32_t>, EVENT_TYPE_COUNT> typeLatestQueued;   // Newest sequence actually queued
+
+    std::array<std::vector<HandlerEntry>, EVENT_TYPE_COUNT> handlers;
+    uint32_t nextSubscriptionId;
+    int dispatchDepth;
+    bool needsCompaction;       // Entries were emptied during dispatch
+
+    std::atomic<OverflowPolicy> overflowPolicy;
+    std::atomic<std::thread::id> consumerThread;   // The thread that calls processEvents()
+    int64_t budgetUs;
+
+    std::atomic<uint64_t> truncatedCount;
+    uint64_t deferredFrames;
+
+    bool dispatchNext(Lane& lane);
+    void dispatch(const Event& event);
+    void compactHandlers();
+    void markQueued(size_t typeIndex, uint32_t sequence);
 };
 
 } // namespace AOS
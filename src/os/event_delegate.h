@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace AOS {
+
+struct Event;
+
+/**
+ * EventDelegate - Allocation-free event handler
+ *
+ * Holds any callable taking (const Event&) inline, in INLINE_SIZE bytes.
+ * Unlike std::function it never allocates and is copied with a memcpy:
+ * the callable must be trivially copyable and destructible, which every
+ * lambda capturing only pointers, references or plain values is. Bigger
+ * state belongs in an object the lambda captures by pointer.
+ */
+class EventDelegate {
+public:
+    static constexpr size_t INLINE_SIZE = 4 * sizeof(void*);
+
+    EventDelegate() : storage(), invoker(nullptr) {}
+
+    template <typename Callable,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<Callable>::type, EventDelegate>::value>::type>
+    EventDelegate(Callable&& callable) {
+        using Stored = typename std::decay<Callable>::type;
+        static_assert(sizeof(Stored) <= INLINE_SIZE,
+                      "EventDelegate: capture too large, capture a pointer to the state instead");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "EventDelegate: over-aligned capture");
+        static_assert(std::is_trivially_copyable<Stored>::value &&
+                      std::is_trivially_destructible<Stored>::value,
+                      "EventDelegate: capture must be trivially copyable (no std::string/shared_ptr)");
+
+        new (storage) Stored(std::forward<Callable>(callable));
+        invoker = [](const void* target, const Event& event) {
+            (*static_cast<Stored*>(const_cast<void*>(target)))(event);
+        };
+    }
+
+    void operator()(const Event& event) const { invoker(storage, event); }
+    explicit operator bool() const { return invoker != nullptr; }
+
+private:
+    using Invoker = void (*)(const void*, const Event&);
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    Invoker invoker;
+};
+
+} // namespace AOS
@@ -0,0 +1,259 @@
+#include "event_recorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace AOS {
+
+namespace {
+
+constexpr char MAGIC[4] = { 'A', 'O', 'S', 'R' };
+constexpr uint8_t TAG_EVENT = 'E';
+constexpr uint8_t TAG_FRAME = 'F';
+constexpr size_t HEADER_SIZE = 16;
+
+// Bounds-checked little-endian reader over the loaded file
+class Reader {
+public:
+    Reader(const std::vector<uint8_t>& bytes) : data(bytes), pos(0), failed(false) {}
+
+    bool atEnd() const { return pos >= data.size(); }
+    bool hasFailed() const { return failed; }
+
+    uint32_t read(size_t size) {
+        if (failed || data.size() - pos < size) {
+            failed = true;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value |= (uint32_t)data[pos + i] << (8 * i);
+        }
+        pos += size;
+        return value;
+    }
+
+    std::string readString(size_t size) {
+        if (failed || data.size() - pos < size) {
+            failed = true;
+            return std::string();
+        }
+        std::string text(reinterpret_cast<const char*>(data.data() + pos), size);
+        pos += size;
+        return text;
+    }
+
+private:
+    const std::vector<uint8_t>& data;
+    size_t pos;
+    bool failed;
+};
+
+} // namespace
+
+EventRecorder::EventRecorder()
+    : recordedFrames(0)
+    , replaying(false)
+    , nextFrame(0)
+    , width(0)
+    , height(0)
+{
+}
+
+EventRecorder::~EventRecorder() {
+    close();
+}
+
+bool EventRecorder::startRecording(const std::string& path, int screenWidth, int screenHeight) {
+    output.open(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        std::cerr << "EventRecorder: cannot write " << path << std::endl;
+        return false;
+    }
+
+    outputPath = path;
+    width = screenWidth;
+    height = screenHeight;
+    recordedFrames = 0;
+    writeBuffer.reserve(WRITE_BUFFER_SIZE);
+
+    for (char c : MAGIC) {
+        putU8((uint8_t)c);
+    }
+    putU16(FORMAT_VERSION);
+    putU16(0);
+    putU32((uint32_t)width);
+    putU32((uint32_t)height);
+
+    std::cout << "EventRecorder: recording input to " << path << std::endl;
+    return true;
+}
+
+void EventRecorder::recordEvent(const Event& event) {
+    if (!isRecording()) {
+        return;
+    }
+
+    std::string_view payload = event.payload.view();
+    putU8(TAG_EVENT);
+    putU8((uint8_t)event.type);
+    putU32((uint32_t)event.data_int);
+    putU16((uint16_t)payload.size());
+    writeBuffer.insert(writeBuffer.end(), payload.begin(), payload.end());
+}
+
+void EventRecorder::recordFrame(uint64_t frameIndex, float deltaTime) {
+    if (!isRecording()) {
+        return;
+    }
+
+    uint32_t deltaBits;
+    std::memcpy(&deltaBits, &deltaTime, sizeof(deltaBits));
+
+    putU8(TAG_FRAME);
+    putU32((uint32_t)frameIndex);
+    putU32(deltaBits);
+    recordedFrames++;
+
+    if (writeBuffer.size() >= WRITE_BUFFER_SIZE) {
+        flushBuffer();
+    }
+}
+
+bool EventRecorder::openReplay(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        std::cerr << "EventRecorder: cannot read " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "EventRecorder: " << path << " is not an input recording" << std::endl;
+        return false;
+    }
+
+    Reader reader(bytes);
+    reader.read(sizeof(MAGIC));
+    uint32_t version = reader.read(2);
+    reader.read(2);
+    width = (int)reader.read(4);
+    height = (int)reader.read(4);
+
+    if (version != FORMAT_VERSION) {
+        std::cerr << "EventRecorder: " << path << " has format version " << version
+                  << ", this build reads " << FORMAT_VERSION << std::endl;
+        return false;
+    }
+
+    events.clear();
+    frames.clear();
+    size_t frameFirstEvent = 0;
+
+    while (!reader.atEnd()) {
+        uint32_t tag = reader.read(1);
+        if (tag == TAG_EVENT) {
+            uint32_t type = reader.read(1);
+            int data = (int)reader.read(4);
+            uint32_t length = reader.read(2);
+            std::string payload = reader.readString(length);
+            if (reader.hasFailed()) {
+                break;
+            }
+            if (type >= EVENT_TYPE_COUNT) {
+                std::cerr << "EventRecorder: unknown event type " << type << " in " << path << std::endl;
+                return false;
+            }
+            events.emplace_back((EventType)type, payload, data);
+        } else if (tag == TAG_FRAME) {
+            uint32_t frameIndex = reader.read(4);
+            uint32_t deltaBits = reader.read(4);
+            if (reader.hasFailed()) {
+                break;
+            }
+            if (frameIndex != frames.size()) {
+                std::cerr << "EventRecorder: frame " << frameIndex << " out of sequence in " << path << std::endl;
+                return false;
+            }
+
+            float deltaTime;
+            std::memcpy(&deltaTime, &deltaBits, sizeof(deltaTime));
+            frames.push_back({ frameFirstEvent, events.size() - frameFirstEvent, deltaTime });
+            frameFirstEvent = events.size();
+        } else {
+            std::cerr << "EventRecorder: corrupt record in " << path << std::endl;
+            return false;
+        }
+    }
+
+    // A truncated tail (e.g. the recording was killed) loses at most the
+    // last frame; everything before it still replays
+    if (reader.hasFailed()) {
+        std::cerr << "EventRecorder: " << path << " is truncated, replaying "
+                  << frames.size() << " complete frames" << std::endl;
+    }
+
+    // Events after the last frame record came with the quit; give them a
+    // final frame so they still reach the apps
+    if (frameFirstEvent < events.size()) {
+        frames.push_back({ frameFirstEvent, events.size() - frameFirstEvent, 0.0f });
+    }
+
+    replaying = true;
+    nextFrame = 0;
+
+    std::cout << "EventRecorder: replaying " << frames.size() << " frames, " << events.size()
+              << " input events from " << path << std::endl;
+    return true;
+}
+
+bool EventRecorder::replayFrame(float& deltaTime) {
+    if (!replaying || nextFrame >= frames.size()) {
+        return false;
+    }
+
+    const ReplayFrame& frame = frames[nextFrame++];
+    EventBus& eventBus = EventBus::getInstance();
+    for (size_t i = 0; i < frame.eventCount; ++i) {
+        eventBus.publish(events[frame.firstEvent + i]);
+    }
+
+    deltaTime = frame.deltaTime;
+    return true;
+}
+
+void EventRecorder::close() {
+    if (!isRecording()) {
+        return;
+    }
+
+    flushBuffer();
+    output.close();
+    std::cout << "EventRecorder: wrote " << recordedFrames << " frames to " << outputPath << std::endl;
+}
+
+void EventRecorder::flushBuffer() {
+    if (writeBuffer.empty()) {
+        return;
+    }
+
+    output.write(reinterpret_cast<const char*>(writeBuffer.data()), (std::streamsize)writeBuffer.size());
+    if (!output) {
+        std::cerr << "EventRecorder: write to " << outputPath << " failed" << std::endl;
+    }
+    writeBuffer.clear();
+}
+
+void EventRecorder::putU16(uint16_t value) {
+    putU8((uint8_t)(value & 0xFF));
+    putU8((uint8_t)(value >> 8));
+}
+
+void EventRecorder::putU32(uint32_t value) {
+    putU16((uint16_t)(value & 0xFFFF));
+    putU16((uint16_t)(value >> 16));
+}
+
+} // namespace AOS
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "event_bus.h"
+
+namespace AOS {
+
+/**
+ * EventRecorder - Deterministic input record and replay
+ *
+ * Recording: the InputManager hands over every event it publishes, and
+ * OSCore reports each frame's index and the deltaTime the apps got. Both
+ * go into a compact binary file. Only input events are recorded; the
+ * events apps publish in response are regenerated on replay.
+ *
+ * Replay: the whole file is loaded up front (no I/O while frames run).
+ * Each frame, replayFrame() publishes that frame's events and returns its
+ * recorded deltaTime, so apps see exactly the same sequence of inputs and
+ * time steps as in the recorded session.
+ *
+ * File layout (little-endian):
+ *   header   "AOSR", u16 version, u16 reserved, u32 width, u32 height
+ *   event    u8 'E', u8 type, i32 data, u16 length, payload bytes
+ *   frame    u8 'F', u32 frame index, f32 deltaTime
+ * A frame record closes the frame: the events before it were published
+ * during that frame's input poll. Recordings are tied to the EventType
+ * numbering, so FORMAT_VERSION changes whenever that does.
+ */
+class EventRecorder {
+public:
+    static constexpr uint16_t FORMAT_VERSION = 1;
+
+    EventRecorder();
+    ~EventRecorder();
+
+    // Non-copyable (owns the output file)
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    // Recording
+    bool startRecording(const std::string& path, int width, int height);
+    void recordEvent(const Event& event);
+    void recordFrame(uint64_t frameIndex, float deltaTime);
+    bool isRecording() const { return output.is_open(); }
+
+    // Replay. openReplay() loads and validates the whole file.
+    bool openReplay(const std::string& path);
+    bool isReplaying() const { return replaying; }
+
+    // Publish the next frame's events; false once the recording is over
+    bool replayFrame(float& deltaTime);
+
+    size_t getFrameCount() const { return replaying ? frames.size() : recordedFrames; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Flush and close the recording (also done by the destructor)
+    void close();
+
+private:
+    struct ReplayFrame {
+        size_t firstEvent;
+        size_t eventCount;
+        float deltaTime;
+    };
+
+    static constexpr size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+    // Recording
+    std::ofstream output;
+    std::string outputPath;
+    std::vector<uint8_t> writeBuffer;
+    size_t recordedFrames;
+
+    // Replay
+    bool replaying;
+    std::vector<Event> events;
+    std::vector<ReplayFrame> frames;
+    size_t nextFrame;
+
+    int width;
+    int height;
+
+    void flushBuffer();
+    void putU8(uint8_t value) { writeBuffer.push_back(value); }
+    void putU16(uint16_t value);
+    void putU32(uint32_t value);
+};
+
+} // namespace AOS
@@ -0,0 +1,250 @@
+#include "frame_profiler.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace AOS {
+
+namespace {
+
+constexpr int OVERLAY_MARGIN = 10;
+constexpr int OVERLAY_PADDING = 8;
+constexpr int GRAPH_HEIGHT = 80;
+constexpr int TEXT_SIZE = 14;
+constexpr int LINE_HEIGHT = 18;
+
+// Value at percentile p (0..1) of an ascending list
+float percentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty()) {
+        return 0.0f;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(std::max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler()
+    : history()
+    , nextSample(0)
+    , sampleCount(0)
+    , current()
+    , frameStart(0)
+    , phaseStart(0)
+    , currentPhase(-1)
+    , ticksToMs(1000.0 / (double)SDL_GetPerformanceFrequency())
+    , overlayVisible(false)
+    , framesSinceOverlayText(OVERLAY_REFRESH_FRAMES)
+    , framesLogged(0)
+{
+}
+
+void FrameProfiler::beginFrame() {
+    current = FrameSample();
+    frameStart = SDL_GetPerformanceCounter();
+    phaseStart = frameStart;
+    currentPhase = -1;
+}
+
+void FrameProfiler::beginPhase(Phase phase) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    closePhase(now);
+    currentPhase = static_cast<int>(phase);
+    phaseStart = now;
+}
+
+void FrameProfiler::endFrame(const RenderCounters& counters) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    closePhase(now);
+    currentPhase = -1;
+
+    current.totalMs = (float)((now - frameStart) * ticksToMs);
+    current.counters = counters;
+    Tracer::getInstance().addComplete("Frame", "frame", frameStart, now);
+
+    if (frameLog.is_open()) {
+        writeFrameLog(current);
+    }
+
+    history[nextSample] = current;
+    nextSample = (nextSample + 1) % HISTORY_SIZE;
+    sampleCount = std::min(sampleCount + 1, HISTORY_SIZE);
+}
+
+FrameProfiler::Percentiles FrameProfiler::getFrameTimeStats() const {
+    return computePercentiles(-1);
+}
+
+FrameProfiler::Percentiles FrameProfiler::getPhaseStats(Phase phase) const {
+    return computePercentiles(static_cast<int>(phase));
+}
+
+const FrameProfiler::FrameSample& FrameProfiler::getWorstFrame() const {
+    size_t worst = 0;
+    for (size_t i = 1; i < sampleCount; ++i) {
+        if (history[i].totalMs > history[worst].totalMs) {
+            worst = i;
+        }
+    }
+    return history[worst];
+}
+
+const FrameProfiler::FrameSample& FrameProfiler::getLastFrame() const {
+    return history[(nextSample + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+std::string FrameProfiler::getSummary() const {
+    Percentiles stats = getFrameTimeStats();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "Frame time (last " << sampleCount << " frames): p50 " << stats.p50
+        << " ms, p95 " << stats.p95 << " ms, p99 " << stats.p99
+        << " ms, worst " << stats.worst << " ms";
+    return oss.str();
+}
+
+bool FrameProfiler::openFrameLog(const std::string& path) {
+    frameLog.open(path, std::ios::trunc);
+    if (!frameLog) {
+        std::cerr << "FrameProfiler: cannot write " << path << std::endl;
+        return false;
+    }
+
+    frameLog << "frame,total_ms";
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        std::string name = getPhaseName(static_cast<Phase>(i));
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        frameLog << "," << name << "_ms";
+    }
+    frameLog << ",draw_calls,textures,text_rasters\n";
+    frameLog << std::fixed << std::setprecision(3);
+    return true;
+}
+
+void FrameProfiler::drawOverlay(Renderer& renderer) {
+    if (++framesSinceOverlayText >= OVERLAY_REFRESH_FRAMES) {
+        framesSinceOverlayText = 0;
+        refreshOverlayText();
+    }
+
+    const int graphWidth = (int)HISTORY_SIZE;
+    const int panelW = 460;
+    const int panelH = GRAPH_HEIGHT + 4 * LINE_HEIGHT + 3 * OVERLAY_PADDING;
+    const int panelX = renderer.getWidth() - panelW - OVERLAY_MARGIN;
+    const int panelY = OVERLAY_MARGIN;
+
+    renderer.drawRect(Rect(panelX, panelY, panelW, panelH), Color(0, 0, 0, 210), true);
+    renderer.drawRect(Rect(panelX, panelY, panelW, panelH), Color(90, 90, 110), false);
+
+    // Frame time graph, oldest on the left; full height is two budgets
+    const int graphX = panelX + OVERLAY_PADDING;
+    const int graphBottom = panelY + OVERLAY_PADDING + GRAPH_HEIGHT;
+    const float msToPixels = GRAPH_HEIGHT / (2.0f * FRAME_BUDGET_MS);
+
+    for (size_t i = 0; i < sampleCount; ++i) {
+        const FrameSample& sample = history[(nextSample + HISTORY_SIZE - sampleCount + i) % HISTORY_SIZE];
+        int barHeight = std::min(GRAPH_HEIGHT, std::max(1, (int)(sample.totalMs * msToPixels)));
+
+        Color barColor = sample.totalMs <= FRAME_BUDGET_MS ? Color(80, 220, 120)
+                       : sample.totalMs <= 2.0f * FRAME_BUDGET_MS ? Color(240, 200, 60)
+                       : Color(240, 70, 60);
+        renderer.drawRect(Rect(graphX + (int)i, graphBottom - barHeight, 1, barHeight), barColor, true);
+    }
+
+    // Budget line
+    int budgetY = graphBottom - (int)(FRAME_BUDGET_MS * msToPixels);
+    renderer.drawRect(Rect(graphX, budgetY, graphWidth, 1), Color(200, 200, 220), true);
+    renderer.drawText("16.7 ms", graphX + graphWidth + OVERLAY_PADDING, budgetY - TEXT_SIZE / 2,
+                      Color(200, 200, 220), TEXT_SIZE);
+
+    int textY = graphBottom + OVERLAY_PADDING;
+    for (const std::string& line : overlayLines) {
+        renderer.drawText(line, graphX, textY, Color::White(), TEXT_SIZE);
+        textY += LINE_HEIGHT;
+    }
+}
+
+const char* FrameProfiler::getPhaseName(Phase phase) {
+    switch (phase) {
+        case Phase::PollInput:      return "Input";
+        case Phase::ProcessEvents:  return "Events";
+        case Phase::Update:         return "Update";
+        case Phase::Render:         return "Render";
+        case Phase::Present:        return "Present";
+        default:                    return "?";
+    }
+}
+
+void FrameProfiler::closePhase(Uint64 now) {
+    if (currentPhase >= 0) {
+        current.phaseMs[currentPhase] += (float)((now - phaseStart) * ticksToMs);
+        Tracer::getInstance().addComplete(getPhaseName(static_cast<Phase>(currentPhase)), "frame",
+                                          phaseStart, now);
+    }
+}
+
+void FrameProfiler::writeFrameLog(const FrameSample& sample) {
+    frameLog << framesLogged++ << "," << sample.totalMs;
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        frameLog << "," << sample.phaseMs[i];
+    }
+    frameLog << "," << sample.counters.drawCalls << "," << sample.counters.textureCreations
+             << "," << sample.counters.textRasterizations << "\n";
+}
+
+FrameProfiler::Percentiles FrameProfiler::computePercentiles(int phase) const {
+    std::vector<float> values;
+    values.reserve(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i) {
+        values.push_back(phase < 0 ? history[i].totalMs : history[i].phaseMs[phase]);
+    }
+    std::sort(values.begin(), values.end());
+
+    Percentiles result = {};
+    result.p50 = percentile(values, 0.50f);
+    result.p95 = percentile(values, 0.95f);
+    result.p99 = percentile(values, 0.99f);
+    result.worst = values.empty() ? 0.0f : values.back();
+    return result;
+}
+
+void FrameProfiler::refreshOverlayText() {
+    Percentiles frame = getFrameTimeStats();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Frame ms  p50 " << frame.p50 << "  p95 " << frame.p95
+        << "  p99 " << frame.p99 << "  worst " << frame.worst;
+    overlayLines[0] = oss.str();
+
+    oss.str("");
+    oss << "p95 ms ";
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        Phase phase = static_cast<Phase>(i);
+        oss << " " << getPhaseName(phase) << " " << getPhaseStats(phase).p95;
+    }
+    overlayLines[1] = oss.str();
+
+    const FrameSample& worst = getWorstFrame();
+    oss.str("");
+    oss << "Worst:";
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        oss << " " << getPhaseName(static_cast<Phase>(i)) << " " << worst.phaseMs[i];
+    }
+    overlayLines[2] = oss.str();
+
+    const RenderCounters& last = getLastFrame().counters;
+    oss.str("");
+    oss << "Last frame: " << last.drawCalls << " draw calls, " << last.textureCreations
+        << " textures, " << last.textRasterizations << " text rasters";
+    overlayLines[3] = oss.str();
+}
+
+} // namespace AOS
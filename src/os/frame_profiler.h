@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "ui/renderer.h"
+
+namespace AOS {
+
+/**
+ * FrameProfiler - Where does the frame time go?
+ *
+ * OSCore marks the start of each main-loop phase; the profiler timestamps
+ * them with the performance counter and keeps the last HISTORY_SIZE frames
+ * (phase times plus the Renderer's work counters) in a ring buffer.
+ * Percentiles and the worst frame are computed over that window on demand.
+ *
+ * The overlay (toggled with F3) graphs frame time against the 60 FPS
+ * budget and lists the stats. Time spent idling after a skipped frame is
+ * not part of any frame; present includes the vsync wait.
+ *
+ * While the Tracer is recording, every frame and phase also becomes a
+ * span in the trace. For whole-run comparisons (e.g. replays of the same
+ * input recording on two builds) every frame can also be logged as CSV.
+ */
+class FrameProfiler {
+public:
+    enum class Phase : uint8_t {
+        PollInput,
+        ProcessEvents,
+        Update,
+        Render,
+        Present,
+        Count
+    };
+
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::Count);
+    static constexpr size_t HISTORY_SIZE = 240;     // 4 seconds at 60 FPS
+    static constexpr float FRAME_BUDGET_MS = 1000.0f / 60.0f;
+
+    struct FrameSample {
+        float phaseMs[PHASE_COUNT];
+        float totalMs;
+        RenderCounters counters;
+    };
+
+    struct Percentiles {
+        float p50;
+        float p95;
+        float p99;
+        float worst;
+    };
+
+    FrameProfiler();
+
+    // Frame bracketing; beginPhase() also ends the previous phase
+    void beginFrame();
+    void beginPhase(Phase phase);
+    void endFrame(const RenderCounters& counters);
+
+    // Stats over the frames currently in the ring buffer
+    size_t getSampleCount() const { return sampleCount; }
+    Percentiles getFrameTimeStats() const;
+    Percentiles getPhaseStats(Phase phase) const;
+    const FrameSample& getWorstFrame() const;
+    const FrameSample& getLastFrame() const;
+
+    // One-line summary (printed when the OS stops)
+    std::string getSummary() const;
+
+    // Append one CSV line per frame from now on
+    bool openFrameLog(const std::string& path);
+
+    // On-screen overlay
+    void toggleOverlay() { overlayVisible = !overlayVisible; }
+    bool isOverlayVisible() const { return overlayVisible; }
+    void drawOverlay(Renderer& renderer);
+
+    static const char* getPhaseName(Phase phase);
+
+private:
+    static constexpr int OVERLAY_REFRESH_FRAMES = 30;   // Text refresh rate
+
+    std::array<FrameSample, HISTORY_SIZE> history;
+    size_t nextSample;
+    size_t sampleCount;
+
+    FrameSample current;
+    Uint64 frameStart;
+    Uint64 phaseStart;
+    int currentPhase;       // -1 between frames
+    double ticksToMs;
+
+    bool overlayVisible;
+    int framesSinceOverlayText;
+    std::string overlayLines[4];
+
+    std::ofstream frameLog;
+    uint64_t framesLogged;
+
+    void closePhase(Uint64 now);
+    void writeFrameLog(const FrameSample& sample);
+    Percentiles computePercentiles(int phase) const;   // -1 = whole frame
+    void refreshOverlayText();
+};
+
+} // namespace AOS
@@ -0,0 +1,387 @@
+#include "job_system.h"
+#include "tracer.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace AOS {
+
+namespace {
+
+// Which deque the calling thread owns: 0 = main thread, -1 = none
+thread_local int t_dequeIndex = -1;
+
+constexpr int64_t DEQUE_MASK = WorkStealingDeque::CAPACITY - 1;
+
+} // namespace
+
+WorkStealingDeque::WorkStealingDeque()
+    : top(0)
+    , bottom(0)
+{
+    for (auto& item : items) {
+        item.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool WorkStealingDeque::push(uint32_t item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= (int64_t)CAPACITY) {
+        return false;
+    }
+
+    items[b & DEQUE_MASK].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingDeque::pop(uint32_t& item) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);   // Empty
+        return false;
+    }
+
+    item = items[b & DEQUE_MASK].load(std::memory_order_relaxed);
+    if (t < b) {
+        return true;
+    }
+
+    // Last item: race the thieves for it
+    bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+}
+
+bool WorkStealingDeque::steal(uint32_t& item) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return false;
+    }
+
+    item = items[t & DEQUE_MASK].load(std::memory_order_relaxed);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::JobSystem()
+    : jobs(new Job[MAX_JOBS])
+    , workerCount(0)
+    , injectionSize(0)
+    , running(false)
+    , queuedJobs(0)
+    , executedCount(0)
+    , stolenCount(0)
+    , poolWaitCount(0)
+    , continuationCount(0)
+{
+    freeJobs.reserve(MAX_JOBS);
+    for (uint32_t i = 0; i < MAX_JOBS; ++i) {
+        jobs[i].parent = NO_JOB;
+        jobs[i].unfinished.store(0, std::memory_order_relaxed);
+        jobs[i].generation.store(1, std::memory_order_relaxed);
+        freeJobs.push_back(MAX_JOBS - 1 - i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+bool JobSystem::start(unsigned requestedWorkers) {
+    if (running.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    if (requestedWorkers == 0) {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        requestedWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    workerCount = std::min(requestedWorkers, MAX_WORKERS);
+
+    t_dequeIndex = 0;
+    running.store(true, std::memory_order_release);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+    }
+
+    std::cout << "JobSystem: " << workerCount << " workers" << std::endl;
+    return true;
+}
+
+void JobSystem::stop() {
+    if (!running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running.store(false, std::memory_order_release);
+    }
+    wakeCondition.notify_all();
+
+    // Workers drain the queues before they exit
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    workerCount = 0;
+
+    // Whatever is left on the main thread's deque (no worker was awake
+    // to steal it) still runs
+    uint32_t job;
+    while (findJob(0, job)) {
+        execute(job);
+    }
+
+    std::lock_guard<std::mutex> lock(mainThreadMutex);
+    mainThreadQueue.clear();
+}
+
+JobSystem::JobHandle JobSystem::createJob(JobFunction work, JobHandle parent) {
+    uint32_t index = NO_JOB;
+    bool waited = false;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!freeJobs.empty()) {
+                index = freeJobs.back();
+                freeJobs.pop_back();
+                break;
+            }
+        }
+
+        // Help until something finishes and frees a slot
+        if (!waited) {
+            poolWaitCount.fetch_add(1, std::memory_order_relaxed);
+            waited = true;
+        }
+        uint32_t other;
+        if (findJob(t_dequeIndex, other)) {
+            execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    Job& job = jobs[index];
+    job.work = std::move(work);
+    job.continuation = nullptr;
+    job.parent = NO_JOB;
+    job.unfinished.store(1, std::memory_order_relaxed);
+
+    if (isLive(parent)) {
+        jobs[parent.index].unfinished.fetch_add(1, std::memory_order_relaxed);
+        job.parent = parent.index;
+    }
+
+    return { index, job.generation.load(std::memory_order_relaxed) };
+}
+
+void JobSystem::setContinuation(JobHandle job, JobFunction onMainThread) {
+    if (isLive(job)) {
+        jobs[job.index].continuation = std::move(onMainThread);
+    }
+}
+
+void JobSystem::run(JobHandle job) {
+    if (!isLive(job)) {
+        return;
+    }
+
+    if (!running.load(std::memory_order_acquire)) {
+        execute(job.index);
+        return;
+    }
+
+    enqueue(job.index);
+}
+
+JobSystem::JobHandle JobSystem::submit(JobFunction work, JobFunction onMainThread, JobHandle parent) {
+    JobHandle job = createJob(std::move(work), parent);
+    if (onMainThread) {
+        setContinuation(job, std::move(onMainThread));
+    }
+    run(job);
+    return job;
+}
+
+void JobSystem::runOnMainThread(JobFunction function) {
+    std::lock_guard<std::mutex> lock(mainThreadMutex);
+    mainThreadQueue.push_back(std::move(function));
+}
+
+bool JobSystem::isComplete(const JobHandle& job) const {
+    return !isLive(job);
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    while (isLive(job)) {
+        uint32_t other;
+        if (findJob(t_dequeIndex, other)) {
+            execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::processMainThreadQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        if (mainThreadQueue.empty()) {
+            return;
+        }
+        mainThreadDraining.swap(mainThreadQueue);
+    }
+
+    // Continuations queued by these run next frame
+    AOS_TRACE_ZONE("JobSystem::continuations", "job");
+    for (JobFunction& function : mainThreadDraining) {
+        function();
+    }
+    continuationCount += mainThreadDraining.size();
+    mainThreadDraining.clear();
+}
+
+JobSystem::Stats JobSystem::getStats() const {
+    Stats stats;
+    stats.executed = executedCount.load(std::memory_order_relaxed);
+    stats.stolen = stolenCount.load(std::memory_order_relaxed);
+    stats.poolWaits = poolWaitCount.load(std::memory_order_relaxed);
+    stats.continuations = continuationCount;
+    return stats;
+}
+
+void JobSystem::workerLoop(unsigned workerIndex) {
+    t_dequeIndex = (int)workerIndex;
+    Tracer::getInstance().setThreadName("Job worker " + std::to_string(workerIndex));
+
+    for (;;) {
+        uint32_t job;
+        if (findJob(t_dequeIndex, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (!running.load(std::memory_order_acquire) && queuedJobs.load(std::memory_order_acquire) <= 0) {
+            break;
+        }
+        wakeCondition.wait(lock, [this]() {
+            return queuedJobs.load(std::memory_order_acquire) > 0 || !running.load(std::memory_order_acquire);
+        });
+    }
+}
+
+bool JobSystem::findJob(int dequeIndex, uint32_t& job) {
+    const int dequeCount = (int)workerCount + 1;
+
+    // Own work first, newest first
+    if (dequeIndex >= 0 && deques[dequeIndex].pop(job)) {
+        queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    if (injectionSize.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injectionQueue.empty()) {
+            job = injectionQueue.back();
+            injectionQueue.pop_back();
+            injectionSize.store(injectionQueue.size(), std::memory_order_release);
+            queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Steal the oldest job from someone else, starting next door so
+    // thieves spread out
+    for (int offset = 1; offset < dequeCount; ++offset) {
+        int victim = ((dequeIndex < 0 ? 0 : dequeIndex) + offset) % dequeCount;
+        if (deques[victim].steal(job)) {
+            queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            stolenCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    if (dequeIndex < 0 && deques[0].steal(job)) {
+        queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+        stolenCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::enqueue(uint32_t job) {
+    queuedJobs.fetch_add(1, std::memory_order_acq_rel);
+
+    if (t_dequeIndex < 0 || !deques[t_dequeIndex].push(job)) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injectionQueue.push_back(job);
+        injectionSize.store(injectionQueue.size(), std::memory_order_release);
+    }
+
+    // Taking the lock orders this with a worker about to sleep
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeCondition.notify_one();
+}
+
+void JobSystem::execute(uint32_t job) {
+    {
+        AOS_TRACE_ZONE("job", "job");
+        jobs[job].work();
+    }
+    executedCount.fetch_add(1, std::memory_order_relaxed);
+    finish(job);
+}
+
+void JobSystem::finish(uint32_t index) {
+    while (index != NO_JOB) {
+        Job& job = jobs[index];
+        if (job.unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;     // Children still running; the last one finishes us
+        }
+
+        if (job.continuation) {
+            runOnMainThread(std::move(job.continuation));
+        }
+        const uint32_t parent = job.parent;
+        release(index);
+        index = parent;
+    }
+}
+
+void JobSystem::release(uint32_t index) {
+    Job& job = jobs[index];
+    job.work = nullptr;
+    job.continuation = nullptr;
+    job.parent = NO_JOB;
+
+    uint32_t generation = job.generation.load(std::memory_order_relaxed) + 1;
+    job.generation.store(generation != 0 ? generation : 1, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    freeJobs.push_back(index);
+}
+
+bool JobSystem::isLive(const JobHandle& job) const {
+    return job.isValid() && job.index < MAX_JOBS &&
+           jobs[job.index].generation.load(std::memory_order_acquire) == job.generation;
+}
+
+} // namespace AOS
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AOS {
+
+/**
+ * WorkStealingDeque - Fixed-size Chase-Lev deque of job indices
+ *
+ * The owning thread pushes and pops at the bottom (LIFO, cache-warm);
+ * any other thread steals from the top (FIFO, oldest work first). Only
+ * a pop or steal racing for the last item needs a CAS. push() returns
+ * false when the deque is full.
+ */
+class WorkStealingDeque {
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    WorkStealingDeque();
+
+    // Owner thread
+    bool push(uint32_t item);
+    bool pop(uint32_t& item);
+
+    // Any thread
+    bool steal(uint32_t& item);
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top;
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom;
+    std::array<std::atomic<uint32_t>, CAPACITY> items;
+};
+
+/**
+ * JobSystem - Background work on the spare cores
+ *
+ * One worker thread per spare core (hardware threads minus the main
+ * thread), each with its own WorkStealingDeque. A job submitted from a
+ * worker goes onto that worker's deque; one submitted from the main
+ * thread goes onto the main thread's deque, from which idle workers
+ * steal. Other threads share a locked injection queue.
+ *
+ * Jobs can have children: a parent counts as finished only once its own
+ * work and all its children are done, so a job can fan out and the
+ * parent's continuation runs after everything. Add children from inside
+ * the parent's work, or before the parent is run.
+ *
+ * A continuation runs on the main thread once its job has finished.
+ * OSCore drains the continuation queue every frame right after events,
+ * which is where results are handed back to apps. Apps must not touch
+ * their own state from job code; continuations can. runOnMainThread()
+ * posts to the same queue from anywhere.
+ *
+ * Jobs come from a fixed pool; when it is exhausted createJob() helps
+ * run queued jobs until one frees up. Before start() (or after stop())
+ * run() executes the job on the calling thread. Completion order across
+ * workers is not deterministic, so OSCore doesn't start the workers in
+ * headless runs: there every job runs inline and its continuation is
+ * delivered in the same frame, which keeps replays reproducible.
+ */
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    struct JobHandle {
+        uint32_t index;
+        uint32_t generation;    // 0 = invalid
+
+        bool isValid() const { return generation != 0; }
+    };
+
+    struct Stats {
+        uint64_t executed;
+        uint64_t stolen;
+        uint64_t poolWaits;         // createJob() found the pool exhausted
+        uint64_t continuations;
+    };
+
+    static constexpr size_t MAX_JOBS = 4096;
+    static constexpr unsigned MAX_WORKERS = 15;
+
+    static JobSystem& getInstance();
+
+    // Start the workers (0 = one per spare hardware thread). The calling
+    // thread becomes the main thread.
+    bool start(unsigned requestedWorkers = 0);
+
+    // Run everything still queued, then join the workers. Continuations
+    // that haven't been delivered are dropped.
+    void stop();
+
+    // Create a job without running it yet (to add children or a
+    // continuation first). An invalid parent means none.
+    JobHandle createJob(JobFunction work, JobHandle parent = JobHandle());
+    void setContinuation(JobHandle job, JobFunction onMainThread);
+    void run(JobHandle job);
+
+    // createJob + setContinuation + run
+    JobHandle submit(JobFunction work, JobFunction onMainThread = nullptr, JobHandle parent = JobHandle());
+
+    // Queue a function for the main thread (any thread)
+    void runOnMainThread(JobFunction function);
+
+    // True once the job and all its children have finished (invalid
+    // handles count as finished)
+    bool isComplete(const JobHandle& job) const;
+
+    // Block until the job is complete, running other jobs meanwhile.
+    // Main thread or workers.
+    void wait(const JobHandle& job);
+
+    // Deliver the queued continuations (main loop)
+    void processMainThreadQueue();
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    unsigned getWorkerCount() const { return workerCount; }
+    Stats getStats() const;
+
+private:
+    JobSystem();
+    ~JobSystem();
+
+    // Non-copyable
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static constexpr uint32_t NO_JOB = UINT32_MAX;
+
+    struct Job {
+        JobFunction work;
+        JobFunction continuation;
+        uint32_t parent;
+        std::atomic<int32_t> unfinished;     // 1 for itself + open children
+        std::atomic<uint32_t> generation;
+    };
+
+    std::unique_ptr<Job[]> jobs;
+    std::vector<uint32_t> freeJobs;
+    std::mutex poolMutex;
+
+    // [0] belongs to the main thread, [1..] to the workers
+    std::array<WorkStealingDeque, MAX_WORKERS + 1> deques;
+    std::vector<std::thread> workers;
+    unsigned workerCount;       // Fixed before the workers start
+
+    std::vector<uint32_t> injectionQueue;
+    std::mutex injectionMutex;
+    std::atomic<size_t> injectionSize;
+
+    std::atomic<bool> running;
+    std::atomic<int64_t> queuedJobs;        // Run but not yet picked up
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    std::vector<JobFunction> mainThreadQueue;
+    std::vector<JobFunction> mainThreadDraining;
+    std::mutex mainThreadMutex;
+
+    std::atomic<uint64_t> executedCount;
+    std::atomic<uint64_t> stolenCount;
+    std::atomic<uint64_t> poolWaitCount;
+    uint64_t continuationCount;
+
+    void workerLoop(unsigned workerIndex);
+    bool findJob(int dequeIndex, uint32_t& job);
+    void enqueue(uint32_t job);
+    void execute(uint32_t job);
+    void finish(uint32_t job);
+    void release(uint32_t job);
+    bool isLive(const JobHandle& job) const;
+};
+
+} // namespace AOS
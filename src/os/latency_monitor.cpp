@@ -0,0 +1,172 @@
+#include "latency_monitor.h"
+#include "ui/renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace AOS {
+
+namespace {
+
+const EventType INPUT_TYPES[] = {
+    EventType::KEY_UP,
+    EventType::KEY_DOWN,
+    EventType::KEY_LEFT,
+    EventType::KEY_RIGHT,
+    EventType::KEY_SELECT,
+    EventType::KEY_BACK
+};
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : buckets()
+    , count(0)
+    , totalNs(0)
+    , maxNs(0)
+{
+}
+
+void LatencyHistogram::add(int64_t latencyNs) {
+    latencyNs = std::max<int64_t>(latencyNs, 0);
+    buckets[getBucket(latencyNs)]++;
+    count++;
+    totalNs += latencyNs;
+    maxNs = std::max(maxNs, latencyNs);
+}
+
+double LatencyHistogram::getPercentileMs(double p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    uint64_t rank = std::max<uint64_t>((uint64_t)std::ceil(p * count), 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(getBucketUpperMs(i), getMaxMs());
+        }
+    }
+    return getMaxMs();
+}
+
+double LatencyHistogram::getMeanMs() const {
+    return count > 0 ? totalNs / 1e6 / count : 0.0;
+}
+
+std::string LatencyHistogram::getSummary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "p50 " << getPercentileMs(0.50) << " ms, p95 " << getPercentileMs(0.95)
+        << " ms, p99 " << getPercentileMs(0.99) << " ms, max " << getMaxMs()
+        << " ms (" << count << " samples)";
+    return oss.str();
+}
+
+int LatencyHistogram::getBucket(int64_t latencyNs) {
+    double us = latencyNs / 1000.0;
+    if (us < 1.0) {
+        return 0;
+    }
+    int bucket = 1 + (int)(std::log2(us) * BUCKETS_PER_OCTAVE);
+    return std::min(bucket, BUCKET_COUNT - 1);
+}
+
+double LatencyHistogram::getBucketUpperMs(int bucket) {
+    if (bucket == BUCKET_COUNT - 1) {
+        return INFINITY;    // Overflow: the caller clamps to the maximum
+    }
+    return std::pow(2.0, (double)bucket / BUCKETS_PER_OCTAVE) / 1000.0;
+}
+
+LatencyMonitor::LatencyMonitor()
+    : subscriptions()
+    , pendingOrigins()
+    , pendingCount(0)
+    , unmatchedInputs(0)
+    , unchangedInputs(0)
+    , markerEnabled(false)
+    , markerState(MarkerState::Idle)
+{
+}
+
+void LatencyMonitor::subscribe() {
+    EventBus& eventBus = EventBus::getInstance();
+    for (size_t i = 0; i < INPUT_TYPE_COUNT; ++i) {
+        subscriptions[i] = eventBus.subscribe(INPUT_TYPES[i], [this](const Event& event) { onInput(event); });
+    }
+}
+
+void LatencyMonitor::unsubscribe() {
+    EventBus& eventBus = EventBus::getInstance();
+    for (auto& subscription : subscriptions) {
+        if (subscription.id != 0) {
+            eventBus.unsubscribe(subscription);
+            subscription.id = 0;
+        }
+    }
+}
+
+void LatencyMonitor::onInput(const Event& event) {
+    dispatchLatency.add(getEventClockNs() - event.timestamp);
+
+    if (pendingCount < MAX_PENDING) {
+        pendingOrigins[pendingCount++] = event.timestamp;
+    } else {
+        unmatchedInputs++;
+    }
+
+    if (markerEnabled) {
+        markerState = MarkerState::Flash;
+    }
+}
+
+void LatencyMonitor::onFramePresented() {
+    if (pendingCount == 0) {
+        return;
+    }
+
+    int64_t now = getEventClockNs();
+    for (size_t i = 0; i < pendingCount; ++i) {
+        presentLatency.add(now - pendingOrigins[i]);
+    }
+    pendingCount = 0;
+}
+
+void LatencyMonitor::onFrameSkipped() {
+    // Timing them against some later, unrelated present would put up to
+    // a second of idle time into the histogram
+    unchangedInputs += pendingCount;
+    pendingCount = 0;
+}
+
+void LatencyMonitor::drawMarker(Renderer& renderer) {
+    if (markerState == MarkerState::Flash) {
+        renderer.drawRect(Rect(0, 0, MARKER_SIZE, MARKER_SIZE), Color::White(), true);
+        markerState = MarkerState::Shown;
+    } else if (markerState == MarkerState::Shown) {
+        markerState = MarkerState::Idle;    // This frame is the one without it
+    }
+}
+
+std::string LatencyMonitor::getSummary() const {
+    if (dispatchLatency.getCount() == 0) {
+        return std::string();
+    }
+
+    std::ostringstream oss;
+    oss << "Input to dispatch: " << dispatchLatency.getSummary() << "\n"
+        << "Input to present:  " << presentLatency.getSummary();
+    if (unchangedInputs > 0) {
+        oss << ", " << unchangedInputs << " inputs changed nothing";
+    }
+    if (unmatchedInputs > 0) {
+        oss << ", " << unmatchedInputs << " inputs not tracked";
+    }
+    return oss.str();
+}
+
+} // namespace AOS
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "event_bus.h"
+
+namespace AOS {
+
+class Renderer;
+
+/**
+ * LatencyHistogram - Log-scale latency distribution
+ *
+ * Buckets are a quarter octave wide (about 19% apart) from 1 us to about
+ * 1 s, plus an overflow bucket, so adding a sample is an increment and
+ * percentiles are read off bucket upper bounds. Count, mean and maximum
+ * are exact.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS_PER_OCTAVE = 4;
+    static constexpr int OCTAVES = 20;
+    static constexpr int BUCKET_COUNT = BUCKETS_PER_OCTAVE * OCTAVES + 2;   // <1 us ... overflow
+
+    LatencyHistogram();
+
+    void add(int64_t latencyNs);
+
+    uint64_t getCount() const { return count; }
+    double getPercentileMs(double p) const;     // p in 0..1
+    double getMeanMs() const;
+    double getMaxMs() const { return maxNs / 1e6; }
+
+    // "p50 1.23 ms, p95 ..., p99 ..., max ... (n samples)"
+    std::string getSummary() const;
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> buckets;
+    uint64_t count;
+    int64_t totalNs;
+    int64_t maxNs;
+
+    static int getBucket(int64_t latencyNs);
+    static double getBucketUpperMs(int bucket);
+};
+
+/**
+ * LatencyMonitor - Input-to-dispatch and input-to-present latency
+ *
+ * Listens to the key events and compares their origin timestamp (when
+ * the HAL saw the input) with when the event reaches the handlers and
+ * when the first frame rendered after it is presented. OSCore subscribes
+ * it before any app so dispatch latency ends where app handlers begin,
+ * and reports the present after SDL_RenderPresent returns; with vsync
+ * that is the swap, the display's own scan-out and response time come on
+ * top.
+ *
+ * For checking against an external camera, marker mode draws a white
+ * square in the top-left corner (clear of the F3 overlay) of the frame
+ * that reflects each input and erases it on the next one: film the
+ * keyboard and the screen and count the frames between key press and
+ * flash.
+ */
+class LatencyMonitor {
+public:
+    static constexpr size_t MAX_PENDING = 64;     // Inputs awaiting a present
+    static constexpr int MARKER_SIZE = 64;
+
+    LatencyMonitor();
+
+    // Main thread; unsubscribe() before the EventBus subscriptions go
+    void subscribe();
+    void unsubscribe();
+
+    // Right after a frame was presented
+    void onFramePresented();
+
+    // The frame after the inputs changed nothing, so there is no present
+    // to time them against; they are counted, not measured
+    void onFrameSkipped();
+
+    // Marker mode: OSCore redraws the whole frame while this is true and
+    // calls drawMarker() last
+    void setMarkerEnabled(bool enabled) { markerEnabled = enabled; }
+    bool needsMarkerRedraw() const { return markerState != MarkerState::Idle; }
+    void drawMarker(Renderer& renderer);
+
+    const LatencyHistogram& getDispatchLatency() const { return dispatchLatency; }
+    const LatencyHistogram& getPresentLatency() const { return presentLatency; }
+
+    // Two lines (dispatch, present), empty if no input was seen
+    std::string getSummary() const;
+
+private:
+    enum class MarkerState {
+        Idle,
+        Flash,      // Draw it in the next frame
+        Shown       // Erase it in the next frame
+    };
+
+    static constexpr size_t INPUT_TYPE_COUNT = 6;
+
+    std::array<EventBus::Subscription, INPUT_TYPE_COUNT> subscriptions;
+    std::array<int64_t, MAX_PENDING> pendingOrigins;
+    size_t pendingCount;
+    uint64_t unmatchedInputs;   // Didn't fit in pendingOrigins
+    uint64_t unchangedInputs;   // Followed by a skipped frame
+
+    LatencyHistogram dispatchLatency;
+    LatencyHistogram presentLatency;
+
+    bool markerEnabled;
+    MarkerState markerState;
+
+    void onInput(const Event& event);
+};
+
+} // namespace AOS
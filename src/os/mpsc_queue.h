@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace AOS {
+
+/**
+ * MpscQueue - Bounded lock-free multi-producer single-consumer ring
+ *
+ * Dmitry Vyukov's bounded queue: every cell carries a sequence number
+ * that tells producers and the consumer whether it is free or filled for
+ * the current lap. A producer claims a cell with one CAS on the enqueue
+ * position, writes the value, then publishes it by bumping the cell's
+ * sequence; the consumer owns the dequeue position outright.
+ *
+ * tryPush() never blocks, locks or allocates (values are copy-assigned
+ * into cells constructed up front); it returns false when the ring is
+ * full. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t requestedCapacity)
+        : capacity(roundUpToPowerOfTwo(requestedCapacity))
+        , mask(capacity - 1)
+        , cells(new Cell[capacity])
+        , enqueuePos(0)
+        , dequeuePos(0)
+    {
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Non-copyable
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread
+    bool tryPush(const T& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // Full: the consumer hasn't freed this cell yet
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. Copy-assigns, so out's storage is reused.
+    bool tryPop(T& out) {
+        return tryConsume([&out](const T& value) { out = value; });
+    }
+
+    // Consumer thread only. Hands the oldest value to consume() where it
+    // lies; the cell is released afterwards. consume() may push.
+    template <typename Consumer>
+    bool tryConsume(Consumer&& consume) {
+        Cell* cell = &cells[dequeuePos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePos + 1) {
+            return false;   // Empty, or the producer is still writing it
+        }
+
+        // Advance first so a reentrant pop can't see this cell again
+        const size_t pos = dequeuePos++;
+        consume(static_cast<const T&>(cell->value));
+        cell->sequence.store(pos + capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread; approximate while producers are active
+    size_t size() const {
+        size_t head = enqueuePos.load(std::memory_order_relaxed);
+        size_t tail = dequeuePos;
+        return head >= tail ? head - tail : 0;
+    }
+
+    size_t getCapacity() const { return capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    // Producers hammer enqueuePos; keep the consumer's index off its line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos;
+    alignas(CACHE_LINE_SIZE) size_t dequeuePos;
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+};
+
+} // namespace AOS
@@ -1,13 +1,82 @@
 #include "os_core.h"
+#include "tracer.h"
+#include "coroutine.h"
+#include "job_system.h"
+#include "timer_service.h"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
 
 namespace AOS {
 
+namespace {
+
+// How long to sleep after a skipped frame: about one vsync interval, so
+// apps still get update() at the usual rate while the GPU idles
+constexpr int IDLE_WAIT_MS = 16;
+
+// Headless runs advance time by exactly one 60 Hz frame per iteration
+constexpr float HEADLESS_FRAME_TIME = 1.0f / 60.0f;
+
+// Above this many regions one clipped pass each costs more than it saves
+constexpr size_t MAX_DAMAGE_REGIONS = 4;
+
+// Clamp regions to the screen and drop empty ones. Returns false if a full
+// redraw is the better deal (no usable regions, or they cover most of it).
+bool normalizeDamage(std::vector<Rect>& regions, int screenWidth, int screenHeight) {
+    size_t kept = 0;
+    long long area = 0;
+
+    for (const Rect& region : regions) {
+        int x1 = std::max(region.x, 0);
+        int y1 = std::max(region.y, 0);
+        int x2 = std::min(region.x + region.w, screenWidth);
+        int y2 = std::min(region.y + region.h, screenHeight);
+        if (x2 <= x1 || y2 <= y1) {
+            continue;
+        }
+        regions[kept++] = Rect(x1, y1, x2 - x1, y2 - y1);
+        area += (long long)(x2 - x1) * (y2 - y1);
+    }
+    regions.erase(regions.begin() + kept, regions.end());
+
+    if (regions.empty()) {
+        return false;
+    }
+
+    // Too many passes: merge everything into one bounding box
+    if (regions.size() > MAX_DAMAGE_REGIONS) {
+        int x1 = screenWidth, y1 = screenHeight, x2 = 0, y2 = 0;
+        for (const Rect& region : regions) {
+            x1 = std::min(x1, region.x);
+            y1 = std::min(y1, region.y);
+            x2 = std::max(x2, region.x + region.w);
+            y2 = std::max(y2, region.y + region.h);
+        }
+        regions.assign(1, Rect(x1, y1, x2 - x1, y2 - y1));
+        area = (long long)(x2 - x1) * (y2 - y1);
+    }
+
+    return area * 2 < (long long)screenWidth * screenHeight;
+}
+
+} // namespace
+
 OSCore::OSCore()
     : window(nullptr)
     , sdlRenderer(nullptr)
+    , headlessSurface(nullptr)
     , running(false)
     , lastFrameTime(0)
+    , frameNumber(0)
+    , partialRedrawSupported(false)
+    , lastFrameSkipped(false)
+    , lastRenderedApp(nullptr)
+    , frameStats{0, 0, 0}
+    , overlayToggled(false)
+    , overlaySubscription{ EventType::TOGGLE_PROFILER_OVERLAY, 0 }
+    , replayDeltaTime(0.0f)
 {
 }
 
@@ -16,54 +85,140 @@ OSCore::~OSCore() {
 }
 
 bool OSCore::initialize(int width, int height, bool fullscreen) {
+    LaunchOptions launchOptions;
+    launchOptions.width = width;
+    launchOptions.height = height;
+    launchOptions.fullscreen = fullscreen;
+    return initialize(launchOptions);
+}
+
+bool OSCore::initialize(const LaunchOptions& launchOptions) {
     std::cout << "=== A-OS Initializing ===" << std::endl;
 
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) != 0) {
-        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
+    options = launchOptions;
 
-    // Create window
-    Uint32 windowFlags = SDL_WINDOW_SHOWN;
-    if (fullscreen) {
-        windowFlags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+    if (!options.traceFile.empty()) {
+        Tracer::getInstance().start(options.traceFile);
     }
-
-    window = SDL_CreateWindow(
-        "A-OS",
-        SDL_WINDOWPOS_CENTERED,
-        SDL_WINDOWPOS_CENTERED,
-        width,
-        height,
-        windowFlags
-    );
-
-    if (!window) {
-        std::cerr << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
-        return false;
+    AOS_TRACE_ZONE("OSCore::initialize", "os");
+
+    // A replay runs headless at the size it was recorded at
+    if (!options.replayFile.empty()) {
+        if (!recorder.openReplay(options.replayFile)) {
+            return false;
+        }
+        options.headless = true;
+        options.width = recorder.getWidth();
+        options.height = recorder.getHeight();
     }
 
-    // Create renderer
-    sdlRenderer = SDL_CreateRenderer(
-        window,
-        -1,
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
-    );
-
-    if (!sdlRenderer) {
-        std::cerr << "SDL_CreateRenderer Error: " << SDL_GetError() << std::endl;
-        return false;
+    if (options.headless) {
+        // No display needed; an explicit SDL_VIDEODRIVER still wins
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+
+        if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+            std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, options.width, options.height, 32,
+                                                         SDL_PIXELFORMAT_ARGB8888);
+        if (!headlessSurface) {
+            std::cerr << "SDL_CreateRGBSurfaceWithFormat Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        sdlRenderer = SDL_CreateSoftwareRenderer(headlessSurface);
+        if (!sdlRenderer) {
+            std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        std::cout << "Headless: software renderer " << options.width << "x" << options.height
+                  << ", no vsync" << std::endl;
+    } else {
+        // Initialize SDL
+        if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) != 0) {
+            std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        // Create window
+        Uint32 windowFlags = SDL_WINDOW_SHOWN;
+        if (options.fullscreen) {
+            windowFlags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+        }
+
+        window = SDL_CreateWindow(
+            "A-OS",
+            SDL_WINDOWPOS_CENTERED,
+            SDL_WINDOWPOS_CENTERED,
+            options.width,
+            options.height,
+            windowFlags
+        );
+
+        if (!window) {
+            std::cerr << "SDL_CreateWindow Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+
+        // Create renderer
+        sdlRenderer = SDL_CreateRenderer(
+            window,
+            -1,
+            SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+        );
+
+        if (!sdlRenderer) {
+            std::cerr << "SDL_CreateRenderer Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
     }
 
-    // Create subsystems
+    // Create subsystems. The latency monitor subscribes to input first,
+    // so it sees each event before any app handler runs
+    latencyMonitor.subscribe();
+    latencyMonitor.setMarkerEnabled(options.latencyMarker);
     renderer = std::make_unique<Renderer>(window, sdlRenderer);
     appManager = std::make_unique<AppManager>();
+    appManager->setMemoryBudget(options.appMemoryBudget);
+    if (!options.headless && !options.usageFile.empty()) {
+        appManager->getUsageStore().load(options.usageFile);
+    }
     inputManager = std::make_unique<InputManager>();
     audioManager = std::make_unique<AudioManager>();
 
     audioManager->initialize();
 
+    // Headless runs (benchmarks, replays) leave the workers off, so jobs
+    // run inline and their continuations land on the same frame every run
+    if (!options.headless) {
+        JobSystem::getInstance().start();
+    }
+
+    if (!options.recordFile.empty()) {
+        if (!recorder.startRecording(options.recordFile, options.width, options.height)) {
+            return false;
+        }
+        inputManager->setRecorder(&recorder);
+    }
+
+    if (!options.frameLogFile.empty() && !profiler.openFrameLog(options.frameLogFile)) {
+        return false;
+    }
+
+    // Partial redraws need a copy of the previous frame to draw over
+    partialRedrawSupported = renderer->setRetainedFrame(true);
+    if (!partialRedrawSupported) {
+        std::cout << "Partial redraws disabled; every changed frame is redrawn in full" << std::endl;
+    }
+
+    overlaySubscription = EventBus::getInstance().subscribe(EventType::TOGGLE_PROFILER_OVERLAY, [this](const Event&) {
+        profiler.toggleOverlay();
+        overlayToggled = true;
+    });
+
     std::cout << "=== A-OS Initialized ===" << std::endl;
 
     return true;
@@ -71,11 +226,32 @@ bool OSCore::initialize(int width, int height, bool fullscreen) {
 
 void OSCore::shutdown() {
     std::cout << "=== A-OS Shutting Down ===" << std::endl;
+    AOS_TRACE_INSTANT("Shutdown", "os", nullptr);
+
+    recorder.close();
+
+    if (overlaySubscription.id != 0) {
+        EventBus::getInstance().unsubscribe(overlaySubscription);
+        overlaySubscription.id = 0;
+    }
+    latencyMonitor.unsubscribe();
+
+    // Jobs may still reference apps; let them finish first
+    JobSystem::getInstance().stop();
 
     if (audioManager) {
         audioManager->shutdown();
     }
 
+    // Apps and the Renderer own SDL textures, so they must let go of
+    // them before the SDL renderer is destroyed
+    if (appManager) {
+        appManager->shutdown();
+        appManager->getUsageStore().save();
+    }
+    TimerService::getInstance().clear();
+    renderer.reset();
+
     if (sdlRenderer) {
         SDL_DestroyRenderer(sdlRenderer);
         sdlRenderer = nullptr;
@@ -86,11 +262,19 @@ void OSCore::shutdown() {
         window = nullptr;
     }
 
+    if (headlessSurface) {
+        SDL_FreeSurface(headlessSurface);
+        headlessSurface = nullptr;
+    }
+
     SDL_Quit();
+
+    // Written last so the shutdown is in the trace
+    Tracer::getInstance().stop();
 }
 
 void OSCore::run() {
-    if (!window || !sdlRenderer) {
+    if (!sdlRenderer || !renderer) {
         std::cerr << "Cannot run: OS not initialized" << std::endl;
         return;
     }
@@ -109,33 +293,219 @@ void OSCore::run() {
     }
 
     std::cout << "=== A-OS Stopped ===" << std::endl;
+    std::cout << "Frames: " << frameStats.framesFull << " full, "
+              << frameStats.framesPartial << " partial, "
+              << frameStats.framesSkipped << " skipped" << std::endl;
+    EventBus& eventBus = EventBus::getInstance();
+    EventBus::Stats eventStats = eventBus.getStats();
+    std::cout << "Events: " << eventStats.published << " published, " << eventStats.dropped
+              << " dropped, " << eventStats.coalesced << " coalesced, "
+              << eventStats.deferredFrames << " frames over budget" << std::endl;
+    for (size_t i = 0; i < EVENT_PRIORITY_COUNT; ++i) {
+        EventPriority priority = static_cast<EventPriority>(i);
+        EventBus::LaneStats lane = eventBus.getLaneStats(priority);
+        if (lane.published == 0) {
+            continue;
+        }
+        std::cout << "  " << getEventPriorityName(priority) << ": " << lane.dispatched << " dispatched, "
+                  << lane.dropped << " dropped, " << lane.coalesced << " coalesced, peak depth "
+                  << lane.highWaterMark << ", latency avg " << lane.averageLatencyUs << " us / max "
+                  << lane.maxLatencyUs << " us" << std::endl;
+    }
+    std::string latencySummary = latencyMonitor.getSummary();
+    if (!latencySummary.empty()) {
+        std::cout << latencySummary << std::endl;
+    }
+    JobSystem::Stats jobStats = JobSystem::getInstance().getStats();
+    if (jobStats.executed > 0) {
+        std::cout << "Jobs: " << jobStats.executed << " run on " << JobSystem::getInstance().getWorkerCount()
+                  << " workers, " << jobStats.stolen << " stolen, " << jobStats.continuations
+                  << " continuations" << std::endl;
+    }
+    AppManager::LaunchStats launchStats = appManager->getLaunchStats();
+    std::cout << "Apps: " << launchStats.coldLaunches << " cold launches, " << launchStats.warmLaunches
+              << " resumed, " << launchStats.evictions << " evicted, " << launchStats.prewarms
+              << " prewarmed (" << launchStats.prewarmedLaunches << " launched ready, "
+              << launchStats.prewarmWaits << " waited, " << launchStats.prewarmsReleased << " released unlaunched)"
+              << std::endl;
+    const auto& installedApps = appManager->getInstalledApps();
+    for (size_t i = 0; i < installedApps.size(); ++i) {
+        if (appManager->isConstructed(i)) {
+            std::cout << "  " << installedApps[i].name << ": constructed in "
+                      << appManager->getConstructionTimeMs(i) << " ms" << std::endl;
+        }
+    }
+    if (appManager->getSimulationSteps() > 0) {
+        std::cout << "Simulation: " << appManager->getSimulationSteps() << " fixed steps, "
+                  << appManager->getDroppedSteps() << " dropped" << std::endl;
+    }
+    if (renderer->getGlyphAtlasRebuilds() > 0) {
+        std::cout << "Text: glyph atlases filled up and were rebuilt "
+                  << renderer->getGlyphAtlasRebuilds() << " times" << std::endl;
+    }
+    std::cout << profiler.getSummary() << std::endl;
 }
 
 void OSCore::mainLoop() {
-    // 1. Poll input
+    // A skipped frame didn't wait for vsync, so sleep until input arrives
+    // or the next frame is due instead. Headless runs never wait: they go
+    // as fast as they can. The idle time is not part of the frame.
+    if (lastFrameSkipped && !options.headless) {
+        int64_t untilTimer = TimerService::getInstance().getTimeUntilNext();
+        int waitMs = untilTimer >= 0 ? (int)std::min<int64_t>(untilTimer, IDLE_WAIT_MS) : IDLE_WAIT_MS;
+        inputManager->waitForInput(waitMs);
+    }
+
+    profiler.beginFrame();
+    Uint64 frameStart = SDL_GetPerformanceCounter();
+
+    // 1. Poll input (a replay publishes the recorded input instead)
+    profiler.beginPhase(FrameProfiler::Phase::PollInput);
     inputManager->pollInput();
     if (inputManager->isQuitRequested()) {
         running = false;
         return;
     }
+    if (recorder.isReplaying() && !recorder.replayFrame(replayDeltaTime)) {
+        running = false;
+        return;
+    }
 
-    // 2. Process events
+    // 2. Fire due timers, process events (timer events included), then
+    //    hand finished background jobs' results back
+    profiler.beginPhase(FrameProfiler::Phase::ProcessEvents);
+    float deltaTime = getDeltaTime();
+    recorder.recordFrame(frameNumber, deltaTime);
+    TimerService::getInstance().advance(deltaTime);
     EventBus::getInstance().processEvents();
+    JobSystem::getInstance().processMainThreadQueue();
 
-    // 3. Update active app
-    float deltaTime = getDeltaTime();
+    // 3. Update active app (coroutines waiting for a frame first)
+    profiler.beginPhase(FrameProfiler::Phase::Update);
+#ifdef AOS_COROUTINES
+    CoroutineScheduler::getInstance().resumeFrame();
+#endif
     appManager->update(deltaTime);
 
-    // 4. Render
-    renderer->clear(Color::Black());
-    appManager->render(*renderer);
-    renderer->present();
+    // 4. Render (only what changed)
+    profiler.beginPhase(FrameProfiler::Phase::Render);
+    renderFrame();
+
+    profiler.endFrame(renderer->getCounters());
+    renderer->resetCounters();
+
+    frameNumber++;
+    if (options.maxFrames > 0 && frameNumber >= options.maxFrames) {
+        running = false;
+    }
+
+    if (recorder.isReplaying() && options.replayRealtime) {
+        waitForReplayFrame(frameStart);
+    }
 
     // 5. Frame rate cap (60 FPS target via VSYNC)
     // VSYNC is enabled in renderer creation, so SDL handles this
 }
 
+void OSCore::renderFrame() {
+    App* activeApp = appManager->getActiveApp();
+
+    if (inputManager->consumeSizeChange()) {
+        renderer->handleResize();
+    }
+
+    // Things the app can't know about invalidate the whole screen
+    bool fullRedraw = activeApp != lastRenderedApp || frameStats.framesFull == 0;
+    fullRedraw |= inputManager->consumeRedrawRequest();
+
+    // The overlay changes every frame and sits on top of everything, and
+    // so does the latency marker while it flashes
+    fullRedraw |= profiler.isOverlayVisible() || overlayToggled;
+    fullRedraw |= latencyMonitor.needsMarkerRedraw();
+    overlayToggled = false;
+
+    // Always ask, so the app can reset its own dirty state
+    damageRegions.clear();
+    bool changed = appManager->collectDamage(damageRegions);
+
+    if (!changed && !fullRedraw) {
+        frameStats.framesSkipped++;
+        lastFrameSkipped = true;
+        latencyMonitor.onFrameSkipped();
+        return;
+    }
+    lastFrameSkipped = false;
+    lastRenderedApp = activeApp;
+
+    // Full redraws go straight to the window, which saves copying the
+    // retained frame every frame for apps that never damage partially.
+    // The first partial frame after one is redrawn in full into the
+    // retained frame, so the ones after it have something to draw over.
+    bool wantsPartial = !fullRedraw && partialRedrawSupported &&
+                        normalizeDamage(damageRegions, renderer->getWidth(), renderer->getHeight());
+    bool partial = wantsPartial && renderer->isRetainedFrameCurrent();
+    renderer->beginFrame(wantsPartial);
+
+    if (!partial) {
+        renderer->clear(Color::Black());
+        appManager->render(*renderer);
+        if (profiler.isOverlayVisible()) {
+            profiler.drawOverlay(*renderer);
+        }
+        latencyMonitor.drawMarker(*renderer);
+        presentFrame();
+        frameStats.framesFull++;
+        return;
+    }
+
+    // clear() ignores the clip rect, so paint the background per region
+    for (const Rect& region : damageRegions) {
+        renderer->setClipRect(region);
+        renderer->drawRect(region, Color::Black(), true);
+        appManager->render(*renderer);
+    }
+    renderer->clearClipRect();
+    presentFrame();
+    frameStats.framesPartial++;
+}
+
+void OSCore::presentFrame() {
+    profiler.beginPhase(FrameProfiler::Phase::Present);
+
+    // The composed frame can only be read back before it is presented
+    if (!options.dumpFramesDir.empty()) {
+        std::ostringstream path;
+        path << options.dumpFramesDir << "/frame_" << std::setfill('0') << std::setw(5)
+             << frameNumber << ".bmp";
+        renderer->saveFrame(path.str());
+    }
+
+    renderer->present();
+    latencyMonitor.onFramePresented();
+}
+
+void OSCore::waitForReplayFrame(Uint64 frameStart) {
+    // Hold the frame for as long as it took when it was recorded
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 due = frameStart + (Uint64)(replayDeltaTime * frequency);
+
+    for (Uint64 now = SDL_GetPerformanceCounter(); now < due; now = SDL_GetPerformanceCounter()) {
+        Uint32 remainingMs = (Uint32)((due - now) * 1000 / frequency);
+        if (remainingMs > 1) {
+            SDL_Delay(remainingMs - 1);   // Sleep most of it, spin the rest
+        }
+    }
+}
+
 float OSCore::getDeltaTime() {
+    if (recorder.isReplaying()) {
+        return replayDeltaTime;
+    }
+
+    if (options.headless) {
+        return HEADLESS_FRAME_TIME;
+    }
+
     Uint64 currentTime = SDL_GetPerformanceCounter();
     Uint64 frequency = SDL_GetPerformanceFrequency();
 
@@ -1,15 +1,63 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <SDL2/SDL.h>
 #include "app_manager.h"
 #include "event_bus.h"
+#include "event_recorder.h"
+#include "frame_profiler.h"
+#include "latency_monitor.h"
 #include "ui/renderer.h"
 #include "hal/input_manager.h"
 #include "hal/audio_manager.h"
 
 namespace AOS {
 
+// How the OS is started (see main.cpp for the command line flags)
+struct LaunchOptions {
+    int width = 1280;
+    int height = 720;
+    bool fullscreen = false;
+
+    // No window: render with the software renderer into a surface, no
+    // vsync, and a fixed 60 Hz timestep so runs are reproducible
+    bool headless = false;
+
+    // Stop after this many main-loop iterations (0 = run until quit)
+    uint64_t maxFrames = 0;
+
+    // If set, every presented frame is written here as frame_NNNNN.bmp
+    std::string dumpFramesDir;
+
+    // If set, record a Chrome trace / Perfetto JSON file here
+    std::string traceFile;
+
+    // Input record/replay (see EventRecorder). Replaying implies headless
+    // at the recorded size; it runs as fast as possible unless
+    // replayRealtime, and stops when the recording ends.
+    std::string recordFile;
+    std::string replayFile;
+    bool replayRealtime = false;
+
+    // If set, every frame's phase times are appended here as CSV
+    std::string frameLogFile;
+
+    // Flash a marker in the frame that reflects each input, for checking
+    // the measured input latency with a camera (see LatencyMonitor)
+    bool latencyMarker = false;
+
+    // Memory the active and suspended apps may hold together before the
+    // least recently used are stopped (0 = stop apps on every switch)
+    size_t appMemoryBudget = AppManager::DEFAULT_MEMORY_BUDGET;
+
+    // App launch counts, kept across runs to prewarm the usual apps at
+    // boot. Headless runs (benchmarks, replays) leave it alone so they
+    // stay reproducible; empty disables it.
+    std::string usageFile = "aos_usage.txt";
+};
+
 /**
  * OSCore - Main OS coordinator
  *
@@ -20,11 +68,16 @@ namespace AOS {
  * - Coordinates frame updates and rendering
  *
  * The main loop is:
- *   1. Poll input
- *   2. Process events
- *   3. Update active app
- *   4. Render active app
+ *   1. Poll input (or replay the recorded input)
+ *   2. Fire due timers, process events, then deliver the main-thread
+ *      continuations of finished jobs
+ *   3. Resume coroutines waiting for a frame (C++20 builds), then update
+ *      the active app
+ *   4. Render active app (skipped, or clipped to the damaged regions,
+ *      when the app reports that little or nothing changed)
  *   5. Cap to 60 FPS
+ *
+ * Each phase is timed by the FrameProfiler (F3 shows its overlay).
  */
 class OSCore {
 public:
@@ -33,6 +86,7 @@ public:
 
     // Initialize the OS
     bool initialize(int width = 1280, int height = 720, bool fullscreen = false);
+    bool initialize(const LaunchOptions& options);
 
     // Shutdown the OS
     void shutdown();
@@ -42,11 +96,22 @@ public:
 
     // Get subsystems (for app registration, etc.)
     AppManager& getAppManager() { return *appManager; }
+    Renderer& getRenderer() { return *renderer; }
+
+    struct FrameStats {
+        uint64_t framesFull;      // Whole screen redrawn
+        uint64_t framesPartial;   // Only damaged regions redrawn
+        uint64_t framesSkipped;   // Nothing changed: no render, no present
+    };
+
+    const FrameStats& getFrameStats() const { return frameStats; }
+    const FrameProfiler& getProfiler() const { return profiler; }
 
 private:
     // SDL components
     SDL_Window* window;
     SDL_Renderer* sdlRenderer;
+    SDL_Surface* headlessSurface;   // Render target in headless mode
 
     // Core subsystems
     std::unique_ptr<Renderer> renderer;
@@ -57,8 +122,32 @@ private:
     // Main loop
     bool running;
     Uint64 lastFrameTime;
+    LaunchOptions options;
+    uint64_t frameNumber;
+
+    // Damage tracking
+    bool partialRedrawSupported;   // Renderer has a retained frame
+    bool lastFrameSkipped;
+    App* lastRenderedApp;
+    std::vector<Rect> damageRegions;
+    FrameStats frameStats;
+
+    // Phase timing and the F3 overlay
+    FrameProfiler profiler;
+    bool overlayToggled;
+    EventBus::Subscription overlaySubscription;
+
+    // Input-to-present latency
+    LatencyMonitor latencyMonitor;
+
+    // Input record/replay
+    EventRecorder recorder;
+    float replayDeltaTime;
 
     void mainLoop();
+    void renderFrame();
+    void presentFrame();
+    void waitForReplayFrame(Uint64 frameStart);
     float getDeltaTime();
 };
 
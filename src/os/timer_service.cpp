@@ -0,0 +1,277 @@
+#include "timer_service.h"
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AOS {
+
+namespace {
+
+constexpr uint64_t SLOT_MASK = TimerService::SLOT_COUNT - 1;
+
+// Longest delay the wheel resolves; later expiries park at the far end
+constexpr uint64_t MAX_WHEEL_DELTA = (1ull << (TimerService::SLOT_BITS * TimerService::LEVEL_COUNT)) - 1;
+
+int countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+TimerService& TimerService::getInstance() {
+    static TimerService instance;
+    return instance;
+}
+
+TimerService::TimerService()
+    : currentTick(0)
+    , pendingMs(0.0)
+    , activeCount(0)
+{
+    slotHeads.fill(NO_NODE);
+    occupied.fill(0);
+}
+
+TimerService::TimerHandle TimerService::schedule(uint32_t delayMs, TimerCallback callback) {
+    TimerHandle handle = add(delayMs, 0);
+    nodes[handle.index].callback = std::move(callback);
+    return handle;
+}
+
+TimerService::TimerHandle TimerService::scheduleRepeating(uint32_t intervalMs, TimerCallback callback) {
+    TimerHandle handle = add(intervalMs, intervalMs);
+    nodes[handle.index].callback = std::move(callback);
+    return handle;
+}
+
+TimerService::TimerHandle TimerService::scheduleEvent(uint32_t delayMs, const Event& event, uint32_t intervalMs) {
+    TimerHandle handle = add(delayMs, intervalMs);
+    nodes[handle.index].publishesEvent = true;
+    nodes[handle.index].event = event;
+    return handle;
+}
+
+bool TimerService::cancel(TimerHandle& handle) {
+    bool cancelled = isActive(handle);
+    if (cancelled) {
+        unlink(handle.index);
+        release(handle.index);
+    }
+    handle = TimerHandle();
+    return cancelled;
+}
+
+bool TimerService::isActive(const TimerHandle& handle) const {
+    return handle.isValid() && handle.index < nodes.size() &&
+           nodes[handle.index].generation == handle.generation && nodes[handle.index].active;
+}
+
+void TimerService::advance(float deltaSeconds) {
+    if (deltaSeconds <= 0.0f) {
+        return;
+    }
+
+    pendingMs += deltaSeconds * 1000.0;
+    uint64_t ticks = (uint64_t)(pendingMs / TICK_MS);
+    pendingMs -= (double)(ticks * TICK_MS);
+
+    while (ticks > 0) {
+        // Nothing to fire or cascade: jump straight to the end
+        if (activeCount == 0) {
+            currentTick += ticks;
+            break;
+        }
+        tick();
+        ticks--;
+    }
+}
+
+int64_t TimerService::getTimeUntilNext() const {
+    if (activeCount == 0) {
+        return -1;
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        if (occupied[level] == 0) {
+            continue;
+        }
+
+        // Rotate so bit 0 is the current slot; it only holds timers a
+        // full lap away, since the rest already cascaded or fired
+        const int shift = SLOT_BITS * level;
+        const uint64_t current = (currentTick >> shift) & SLOT_MASK;
+        uint64_t rotated = current == 0 ? occupied[level]
+                                        : (occupied[level] >> current) | (occupied[level] << (SLOT_COUNT - current));
+        uint64_t distance = (rotated >> 1) != 0 ? (uint64_t)countTrailingZeros(rotated >> 1) + 1 : SLOT_COUNT;
+
+        // A coarser slot is due when it cascades, the earliest it can fire
+        uint64_t due = (((currentTick >> shift) + distance) << shift) - currentTick;
+        best = std::min(best, due);
+    }
+
+    int64_t remainingMs = (int64_t)(best * TICK_MS) - (int64_t)std::ceil(pendingMs);
+    return std::max<int64_t>(remainingMs, 0);
+}
+
+void TimerService::clear() {
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].active) {
+            unlink(i);
+            release(i);
+        }
+    }
+}
+
+TimerService::TimerHandle TimerService::add(uint32_t delayMs, uint32_t intervalMs) {
+    uint32_t index;
+    if (!freeNodes.empty()) {
+        index = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        index = (uint32_t)nodes.size();
+        nodes.emplace_back();
+        nodes[index].generation = 1;
+    }
+
+    // Round up, and never fire within the tick it was scheduled in
+    TimerNode& node = nodes[index];
+    uint64_t delayTicks = std::max<uint64_t>((delayMs + TICK_MS - 1) / TICK_MS, 1);
+    node.expires = currentTick + delayTicks;
+    node.interval = intervalMs > 0 ? std::max<uint32_t>((intervalMs + TICK_MS - 1) / TICK_MS, 1) : 0;
+    node.active = true;
+    node.publishesEvent = false;
+    insert(index);
+    activeCount++;
+
+    return { index, node.generation };
+}
+
+void TimerService::insert(uint32_t index) {
+    TimerNode& node = nodes[index];
+
+    uint64_t delta = node.expires > currentTick ? node.expires - currentTick : 0;
+    uint64_t placement = currentTick + std::min(delta, MAX_WHEEL_DELTA);
+    delta = placement - currentTick;
+
+    int level = 0;
+    while (level < LEVEL_COUNT - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    const uint32_t slot = (uint32_t)((placement >> (SLOT_BITS * level)) & SLOT_MASK);
+    const uint32_t list = level * SLOT_COUNT + slot;
+
+    node.slotList = (uint16_t)list;
+    node.prev = NO_NODE;
+    node.next = slotHeads[list];
+    if (node.next != NO_NODE) {
+        nodes[node.next].prev = index;
+    }
+    slotHeads[list] = index;
+    occupied[level] |= 1ull << slot;
+}
+
+void TimerService::unlink(uint32_t index) {
+    TimerNode& node = nodes[index];
+    const uint32_t list = node.slotList;
+
+    if (node.prev != NO_NODE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slotHeads[list] = node.next;
+    }
+    if (node.next != NO_NODE) {
+        nodes[node.next].prev = node.prev;
+    }
+    if (slotHeads[list] == NO_NODE) {
+        occupied[list / SLOT_COUNT] &= ~(1ull << (list % SLOT_COUNT));
+    }
+    node.prev = NO_NODE;
+    node.next = NO_NODE;
+}
+
+void TimerService::release(uint32_t index) {
+    TimerNode& node = nodes[index];
+    node.active = false;
+    node.callback = nullptr;
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    freeNodes.push_back(index);
+    activeCount--;
+}
+
+void TimerService::cascade(int level) {
+    const uint32_t slot = (uint32_t)((currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    const uint32_t list = level * SLOT_COUNT + slot;
+
+    while (slotHeads[list] != NO_NODE) {
+        uint32_t index = slotHeads[list];
+        unlink(index);
+        insert(index);
+    }
+}
+
+void TimerService::tick() {
+    currentTick++;
+
+    // Each time a level wraps, the next coarser slot moves down
+    for (int level = 1; level < LEVEL_COUNT; ++level) {
+        if ((currentTick & ((1ull << (SLOT_BITS * level)) - 1)) != 0) {
+            break;
+        }
+        cascade(level);
+    }
+
+    // Everything new lands in later slots, so this drains
+    const uint32_t list = (uint32_t)(currentTick & SLOT_MASK);
+    while (slotHeads[list] != NO_NODE) {
+        uint32_t index = slotHeads[list];
+        unlink(index);
+        if (nodes[index].expires > currentTick) {
+            insert(index);      // Parked beyond the wheel's range
+        } else {
+            fire(index);
+        }
+    }
+}
+
+void TimerService::fire(uint32_t index) {
+    AOS_TRACE_ZONE("timer", "os");
+
+    // Callbacks may schedule (growing nodes) or cancel themselves, so
+    // re-arm or release first and call a copy
+    TimerNode& node = nodes[index];
+    if (node.interval > 0) {
+        node.expires = std::max(node.expires + node.interval, currentTick + 1);
+        insert(index);
+        if (node.publishesEvent) {
+            EventBus::getInstance().publish(node.event);
+        } else {
+            TimerCallback callback = node.callback;
+            callback();
+        }
+        return;
+    }
+
+    if (node.publishesEvent) {
+        Event event = node.event;
+        release(index);
+        EventBus::getInstance().publish(event);
+    } else {
+        TimerCallback callback = std::move(node.callback);
+        release(index);
+        callback();
+    }
+}
+
+} // namespace AOS
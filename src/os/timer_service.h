@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "event_bus.h"
+
+namespace AOS {
+
+/**
+ * TimerService - Delayed and periodic callbacks on the OS clock
+ *
+ * Apps schedule a callback or an EventBus event after a delay, once or
+ * repeating, and cancel it through the returned handle. The clock is the
+ * main loop's frame time (advance() is called once per frame before
+ * events are processed), so timers pause with the loop and replay
+ * deterministically.
+ *
+ * Timers live in a hierarchical timing wheel: LEVEL_COUNT wheels of
+ * SLOT_COUNT slots, each level SLOT_COUNT times coarser than the one
+ * below. A timer goes into the coarsest slot that still resolves its
+ * expiry and cascades down as its time approaches, so scheduling,
+ * cancelling and firing are O(1) however many timers exist. Nodes come
+ * from a pool and sit on intrusive lists, so steady-state scheduling
+ * doesn't allocate. Per-level occupancy bitmasks make the next wake-up
+ * deadline cheap to find for the idle wait.
+ *
+ * Main thread only. Callbacks may schedule and cancel timers, including
+ * their own.
+ */
+class TimerService {
+public:
+    using TimerCallback = std::function<void()>;
+
+    struct TimerHandle {
+        uint32_t index;
+        uint32_t generation;    // 0 = invalid
+
+        bool isValid() const { return generation != 0; }
+    };
+
+    static constexpr uint32_t TICK_MS = 1;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint32_t SLOT_COUNT = 1u << SLOT_BITS;
+    static constexpr int LEVEL_COUNT = 4;   // Covers 2^24 ms (about 4.6 h); longer delays re-cascade
+
+    static TimerService& getInstance();
+
+    // One-shot callback after delayMs (at least one tick)
+    TimerHandle schedule(uint32_t delayMs, TimerCallback callback);
+
+    // Callback every intervalMs, the first one after intervalMs
+    TimerHandle scheduleRepeating(uint32_t intervalMs, TimerCallback callback);
+
+    // Publish an event after delayMs, then every intervalMs if non-zero
+    TimerHandle scheduleEvent(uint32_t delayMs, const Event& event, uint32_t intervalMs = 0);
+
+    // Cancel a pending timer and invalidate the handle. False if it had
+    // already fired (one-shot) or was cancelled.
+    bool cancel(TimerHandle& handle);
+    bool isActive(const TimerHandle& handle) const;
+
+    // Advance the clock and fire everything that came due (main loop)
+    void advance(float deltaSeconds);
+
+    // Milliseconds until the next timer may fire, or -1 if none is
+    // pending. Never later than the real deadline; it can be earlier for
+    // timers that still have to cascade.
+    int64_t getTimeUntilNext() const;
+
+    uint64_t getNow() const { return currentTick; }
+    size_t getActiveCount() const { return activeCount; }
+
+    // Cancel everything
+    void clear();
+
+private:
+    TimerService();
+    ~TimerService() = default;
+
+    // Non-copyable
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct TimerNode {
+        uint64_t expires;       // Tick it fires at
+        uint32_t interval;      // Ticks between repeats; 0 = one-shot
+        uint32_t generation;    // Bumped on release, so stale handles miss
+        uint32_t prev;
+        uint32_t next;
+        uint16_t slotList;      // level * SLOT_COUNT + slot, while queued
+        bool active;
+        bool publishesEvent;
+        TimerCallback callback;
+        Event event;
+    };
+
+    std::vector<TimerNode> nodes;
+    std::vector<uint32_t> freeNodes;
+    std::array<uint32_t, LEVEL_COUNT * SLOT_COUNT> slotHeads;
+    std::array<uint64_t, LEVEL_COUNT> occupied;     // Bit per non-empty slot
+
+    uint64_t currentTick;
+    double pendingMs;           // Fraction of a tick carried to the next frame
+    size_t activeCount;
+
+    TimerHandle add(uint32_t delayMs, uint32_t intervalMs);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+    void fire(uint32_t index);
+    void tick();
+};
+
+} // namespace AOS
@@ -0,0 +1,225 @@
+#include "tracer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace AOS {
+
+namespace {
+
+// Minimal JSON string escaping (names and details are short ASCII)
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << (int)static_cast<unsigned char>(*c) << std::dec << std::setfill(' ');
+                } else {
+                    out << *c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+// Copy, truncating to fit (names and details are short ASCII)
+void copyDetail(char* target, const char* detail) {
+    if (!detail) {
+        target[0] = '\0';
+        return;
+    }
+    std::strncpy(target, detail, Tracer::DETAIL_CAPACITY - 1);
+    target[Tracer::DETAIL_CAPACITY - 1] = '\0';
+}
+
+} // namespace
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::Tracer()
+    : enabled(false)
+    , originTicks(0)
+    , ticksToMicros(1000000.0 / (double)SDL_GetPerformanceFrequency())
+{
+}
+
+bool Tracer::start(const std::string& path) {
+    if (isEnabled()) {
+        std::cerr << "Tracer: already recording to " << outputPath << std::endl;
+        return false;
+    }
+
+    // Fail now rather than after a long session
+    std::ofstream probe(path);
+    if (!probe) {
+        std::cerr << "Tracer: cannot write " << path << std::endl;
+        return false;
+    }
+
+    outputPath = path;
+    originTicks = SDL_GetPerformanceCounter();
+    enabled.store(true, std::memory_order_relaxed);
+
+    std::cout << "Tracer: recording to " << path << std::endl;
+    return true;
+}
+
+bool Tracer::stop() {
+    if (!isEnabled()) {
+        return false;
+    }
+    enabled.store(false, std::memory_order_relaxed);
+
+    std::ofstream out(outputPath);
+    if (!out) {
+        std::cerr << "Tracer: cannot write " << outputPath << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"A-OS\"}}";
+
+    size_t eventCount = 0;
+    uint64_t overwrittenCount = 0;
+
+    std::lock_guard<std::mutex> buffersLock(buffersMutex);
+    for (auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->threadName.c_str());
+        out << "}}";
+
+        // Oldest first: once the ring wrapped that is the slot written next
+        const size_t count = (size_t)std::min<uint64_t>(buffer->recorded, EVENTS_PER_THREAD);
+        const size_t first = buffer->recorded > EVENTS_PER_THREAD
+            ? (size_t)(buffer->recorded % EVENTS_PER_THREAD) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[(first + i) % EVENTS_PER_THREAD];
+            const double ts = (double)(event.startTicks - originTicks) * ticksToMicros;
+
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+            if (event.instant) {
+                out << ",\"ph\":\"i\",\"s\":\"g\"";
+            } else {
+                out << ",\"ph\":\"X\",\"dur\":" << (double)(event.endTicks - event.startTicks) * ticksToMicros;
+            }
+            out << ",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << buffer->threadId;
+            if (event.detail[0] != '\0') {
+                out << ",\"args\":{\"detail\":";
+                writeJsonString(out, event.detail);
+                out << "}";
+            }
+            out << "}";
+        }
+
+        eventCount += count;
+        overwrittenCount += buffer->recorded - count;
+        buffer->recorded = 0;
+    }
+
+    out << "\n]}\n";
+
+    std::cout << "Tracer: wrote " << eventCount << " events to " << outputPath;
+    if (overwrittenCount > 0) {
+        std::cout << " (the last ones; " << overwrittenCount << " older events overwritten)";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+void Tracer::addComplete(const char* name, const char* category, Uint64 startTicks, Uint64 endTicks,
+                         const char* detail) {
+    if (!isEnabled()) {
+        return;
+    }
+    // Spans already running when recording started are clipped to the start
+    startTicks = std::max(startTicks, originTicks);
+    endTicks = std::max(endTicks, startTicks);
+    record(name, category, startTicks, endTicks, false, detail);
+}
+
+void Tracer::addInstant(const char* name, const char* category, const char* detail) {
+    if (!isEnabled()) {
+        return;
+    }
+    Uint64 now = SDL_GetPerformanceCounter();
+    record(name, category, now, now, true, detail);
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+    // Buffers live as long as the tracer, so the cached pointer stays valid
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+    if (!threadBuffer) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->threadId = (uint32_t)buffers.size() + 1;
+        buffer->threadName = buffers.empty() ? "Main" : "Thread " + std::to_string(buffer->threadId);
+        buffer->events.reset(new TraceEvent[EVENTS_PER_THREAD]);
+        buffer->recorded = 0;
+        threadBuffer = buffer.get();
+        buffers.push_back(std::move(buffer));
+    }
+    return *threadBuffer;
+}
+
+void Tracer::record(const char* name, const char* category, Uint64 startTicks, Uint64 endTicks, bool instant,
+                    const char* detail) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    // Overwrites the oldest event once the ring is full
+    TraceEvent& event = buffer.events[buffer.recorded % EVENTS_PER_THREAD];
+    event.name = name;
+    event.category = category;
+    event.startTicks = startTicks;
+    event.endTicks = endTicks;
+    event.instant = instant;
+    copyDetail(event.detail, detail);
+    buffer.recorded++;
+}
+
+TraceZone::TraceZone(const char* zoneName, const char* zoneCategory, const char* zoneDetail)
+    : name(zoneName)
+    , category(zoneCategory)
+    , startTicks(0)
+    , active(Tracer::getInstance().isEnabled())
+{
+    if (active) {
+        copyDetail(detail, zoneDetail);
+        startTicks = SDL_GetPerformanceCounter();
+    }
+}
+
+TraceZone::~TraceZone() {
+    if (active) {
+        Tracer::getInstance().addComplete(name, category, startTicks, SDL_GetPerformanceCounter(),
+                                          detail[0] != '\0' ? detail : nullptr);
+    }
+}
+
+} // namespace AOS
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AOS {
+
+/**
+ * Tracer - Trace Event Format (Chrome trace / Perfetto) recorder
+ *
+ * Code marks spans with AOS_TRACE_ZONE and one-off moments with
+ * AOS_TRACE_INSTANT. While tracing is off each of those costs one relaxed
+ * atomic load. While it is on, events go into a fixed ring owned by the
+ * calling thread (one track per thread in the viewer), guarded by that
+ * ring's own mutex, which is only ever contended by stop(). Recording
+ * never allocates after a thread's first event.
+ *
+ * The rings are a flight recorder: once full, each new event overwrites
+ * the oldest, so tracing can stay on for a whole session in bounded
+ * memory (EVENTS_PER_THREAD events per thread) and stop() writes the
+ * most recent stretch - the one that ends with the stutter - as JSON
+ * that loads in ui.perfetto.dev or chrome://tracing.
+ *
+ * Names and categories must be string literals (they are stored as
+ * pointers); details are copied, truncated to DETAIL_CAPACITY - 1 chars.
+ */
+class Tracer {
+public:
+    // Ring size per thread (about 2.3 MB each)
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 15;
+    static constexpr size_t DETAIL_CAPACITY = 32;
+
+    static Tracer& getInstance();
+
+    // Begin recording; the file is written by stop()
+    bool start(const std::string& path);
+
+    // Stop recording and write the trace file
+    bool stop();
+
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Label the calling thread's track
+    void setThreadName(const std::string& name);
+
+    // Record a span measured elsewhere, in SDL performance counter ticks
+    void addComplete(const char* name, const char* category, Uint64 startTicks, Uint64 endTicks,
+                     const char* detail = nullptr);
+
+    // Record a moment visible across all tracks (e.g. an app transition)
+    void addInstant(const char* name, const char* category, const char* detail = nullptr);
+
+private:
+    Tracer();
+    ~Tracer() = default;
+
+    // Non-copyable
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    struct TraceEvent {
+        const char* name;
+        const char* category;
+        Uint64 startTicks;
+        Uint64 endTicks;      // Equal to startTicks for instants
+        bool instant;
+        char detail[DETAIL_CAPACITY];   // Empty string if none
+    };
+
+    struct ThreadBuffer {
+        uint32_t threadId;
+        std::string threadName;
+        std::mutex mutex;
+        std::unique_ptr<TraceEvent[]> events;   // Ring of EVENTS_PER_THREAD
+        uint64_t recorded;                      // Since start(); the ring holds the last ones
+    };
+
+    std::atomic<bool> enabled;
+    std::string outputPath;
+    Uint64 originTicks;
+    double ticksToMicros;
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer& getThreadBuffer();
+    void record(const char* name, const char* category, Uint64 startTicks, Uint64 endTicks, bool instant,
+                const char* detail);
+};
+
+/**
+ * TraceZone - RAII span; use through AOS_TRACE_ZONE
+ */
+class TraceZone {
+public:
+    TraceZone(const char* name, const char* category, const char* detail = nullptr);
+    ~TraceZone();
+
+    // Non-copyable
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    char detail[Tracer::DETAIL_CAPACITY];
+    Uint64 startTicks;
+    bool active;
+};
+
+} // namespace AOS
+
+#define AOS_TRACE_CONCAT_INNER(a, b) a##b
+#define AOS_TRACE_CONCAT(a, b) AOS_TRACE_CONCAT_INNER(a, b)
+
+// Span covering the rest of the enclosing scope
+#define AOS_TRACE_ZONE(name, category) \
+    ::AOS::TraceZone AOS_TRACE_CONCAT(aosTraceZone_, __LINE__)(name, category)
+
+// Same, with a detail string shown in the span's args
+#define AOS_TRACE_ZONE_DETAIL(name, category, detail) \
+    ::AOS::TraceZone AOS_TRACE_CONCAT(aosTraceZone_, __LINE__)(name, category, detail)
+
+#define AOS_TRACE_INSTANT(name, category, detail)                              \
+    do {                                                                        \
+        if (::AOS::Tracer::getInstance().isEnabled()) {                         \
+            ::AOS::Tracer::getInstance().addInstant(name, category, detail);    \
+        }                                                                       \
+    } while (0)
@@ -0,0 +1,89 @@
+#include "circle_cache.h"
+
+#include <algorithm>
+
+namespace AOS {
+
+const CircleCache::Table& CircleCache::get(int radius) {
+    if (radius < 0) {
+        radius = 0;
+    }
+
+    if (radius > MAX_CACHED_RADIUS) {
+        build(radius, scratch);
+        return scratch;
+    }
+
+    if (static_cast<size_t>(radius) >= tables.size()) {
+        tables.resize(radius + 1);
+    }
+
+    auto& table = tables[radius];
+    if (!table) {
+        table = std::make_unique<Table>();
+        build(radius, *table);
+    }
+    return *table;
+}
+
+void CircleCache::build(int radius, Table& table) {
+    table.radius = radius;
+    table.halfWidths.assign(2 * radius + 1, 0);
+    table.fill.clear();
+    table.outline.clear();
+
+    // Midpoint circle algorithm: record the widest span per row and each
+    // outline pixel. This is exactly what drawCircle used to emit per call.
+    int x = radius;
+    int y = 0;
+    int radiusError = 1 - x;
+
+    auto widen = [&](int dy, int halfWidth) {
+        int& current = table.halfWidths[dy + radius];
+        current = std::max(current, halfWidth);
+    };
+
+    while (x >= y) {
+        widen(y, x);
+        widen(-y, x);
+        widen(x, y);
+        widen(-x, y);
+
+        const SDL_Point octants[8] = {
+            { x, y }, { -x, y }, { x, -y }, { -x, -y },
+            { y, x }, { -y, x }, { y, -x }, { -y, -x }
+        };
+        table.outline.insert(table.outline.end(), octants, octants + 8);
+
+        y++;
+        if (radiusError < 0) {
+            radiusError += 2 * y + 1;
+        } else {
+            x--;
+            radiusError += 2 * (y - x + 1);
+        }
+    }
+
+    // Octant boundaries produce duplicate pixels; drop them
+    std::sort(table.outline.begin(), table.outline.end(), [](const SDL_Point& a, const SDL_Point& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    table.outline.erase(std::unique(table.outline.begin(), table.outline.end(),
+                                    [](const SDL_Point& a, const SDL_Point& b) {
+                                        return a.x == b.x && a.y == b.y;
+                                    }),
+                        table.outline.end());
+
+    // Merge runs of rows with the same width into single rectangles
+    for (int dy = -radius; dy <= radius;) {
+        const int halfWidth = table.halfWidth(dy);
+        int end = dy + 1;
+        while (end <= radius && table.halfWidth(end) == halfWidth) {
+            end++;
+        }
+        table.fill.push_back({ -halfWidth, dy, 2 * halfWidth + 1, end - dy });
+        dy = end;
+    }
+}
+
+} // namespace AOS
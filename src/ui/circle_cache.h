@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+
+namespace AOS {
+
+/**
+ * CircleCache - Precomputed midpoint-circle span tables, one per radius
+ *
+ * The midpoint algorithm only depends on the radius, so its output is
+ * computed once and reused for every circle, rounded-rect corner and shadow
+ * layer of that size. Each table holds:
+ * - halfWidths: filled extent of every row, dy = -radius .. radius
+ * - fill: the same rows merged into as few rectangles as possible
+ * - outline: the distinct outline pixels
+ * All coordinates are relative to the circle center.
+ */
+class CircleCache {
+public:
+    struct Table {
+        int radius;
+        std::vector<int> halfWidths;     // Index dy + radius
+        std::vector<SDL_Rect> fill;      // Non-overlapping spans covering the disc
+        std::vector<SDL_Point> outline;  // One entry per outline pixel
+
+        // Filled half-width for row dy (must be within [-radius, radius])
+        int halfWidth(int dy) const { return halfWidths[dy + radius]; }
+    };
+
+    CircleCache() = default;
+
+    // Non-copyable
+    CircleCache(const CircleCache&) = delete;
+    CircleCache& operator=(const CircleCache&) = delete;
+
+    // Get (building on first use) the table for a radius >= 0
+    const Table& get(int radius);
+
+    // Drop all tables
+    void clear() { tables.clear(); }
+
+private:
+    // Radii above this are built into a scratch table instead of being kept
+    static constexpr int MAX_CACHED_RADIUS = 1024;
+
+    std::vector<std::unique_ptr<Table>> tables;  // Index = radius
+    Table scratch;
+
+    static void build(int radius, Table& table);
+};
+
+} // namespace AOS
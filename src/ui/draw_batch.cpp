@@ -0,0 +1,102 @@
+#include "draw_batch.h"
+
+#include <iostream>
+
+namespace AOS {
+
+DrawBatch::DrawBatch(SDL_Renderer* sdlRend)
+    : sdlRenderer(sdlRend)
+    , currentTexture(nullptr)
+    , flushCount(0)
+    , offsetX(0.0f)
+    , offsetY(0.0f)
+    , forceOpaque(false)
+{
+    vertices.reserve(INITIAL_VERTEX_CAPACITY);
+    indices.reserve(INITIAL_VERTEX_CAPACITY / 4 * 6);
+}
+
+void DrawBatch::addRect(float x, float y, float w, float h, const SDL_Color& color) {
+    if (w <= 0.0f || h <= 0.0f) {
+        return;
+    }
+
+    useTexture(nullptr);
+    pushQuadIndices();
+
+    x += offsetX;
+    y += offsetY;
+    const SDL_Color fill = solidColor(color);
+    const SDL_FPoint noUV = { 0.0f, 0.0f };
+    vertices.push_back({ { x, y }, fill, noUV });
+    vertices.push_back({ { x + w, y }, fill, noUV });
+    vertices.push_back({ { x + w, y + h }, fill, noUV });
+    vertices.push_back({ { x, y + h }, fill, noUV });
+}
+
+void DrawBatch::addQuad(const SDL_FPoint (&corners)[4], const SDL_Color& color) {
+    useTexture(nullptr);
+    pushQuadIndices();
+
+    const SDL_Color fill = solidColor(color);
+    const SDL_FPoint noUV = { 0.0f, 0.0f };
+    for (const SDL_FPoint& corner : corners) {
+        vertices.push_back({ { corner.x + offsetX, corner.y + offsetY }, fill, noUV });
+    }
+}
+
+void DrawBatch::addTexturedRect(SDL_Texture* texture, const SDL_FRect& dest, const SDL_FRect& uv,
+                                const SDL_Color& color) {
+    useTexture(texture);
+    pushQuadIndices();
+
+    const float left = dest.x + offsetX;
+    const float top = dest.y + offsetY;
+    const float right = left + dest.w;
+    const float bottom = top + dest.h;
+    const float u1 = uv.x + uv.w;
+    const float v1 = uv.y + uv.h;
+
+    vertices.push_back({ { left, top }, color, { uv.x, uv.y } });
+    vertices.push_back({ { right, top }, color, { u1, uv.y } });
+    vertices.push_back({ { right, bottom }, color, { u1, v1 } });
+    vertices.push_back({ { left, bottom }, color, { uv.x, v1 } });
+}
+
+void DrawBatch::flush() {
+    if (indices.empty()) {
+        return;
+    }
+
+    if (SDL_RenderGeometry(sdlRenderer, currentTexture,
+                           vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size())) != 0) {
+        std::cerr << "SDL_RenderGeometry failed: " << SDL_GetError() << std::endl;
+    }
+
+    vertices.clear();
+    indices.clear();
+    flushCount++;
+}
+
+SDL_Color DrawBatch::solidColor(const SDL_Color& color) const {
+    if (forceOpaque) {
+        return { color.r, color.g, color.b, 255 };
+    }
+    return color;
+}
+
+void DrawBatch::useTexture(SDL_Texture* texture) {
+    if (texture != currentTexture) {
+        flush();
+        currentTexture = texture;
+    }
+}
+
+void DrawBatch::pushQuadIndices() {
+    const int base = static_cast<int>(vertices.size());
+    const int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+    indices.insert(indices.end(), quad, quad + 6);
+}
+
+} // namespace AOS
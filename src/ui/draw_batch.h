@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+#error "A-OS needs SDL 2.0.18 or newer (SDL_RenderGeometry)"
+#endif
+
+namespace AOS {
+
+/**
+ * DrawBatch - Deferred triangle buffer flushed through SDL_RenderGeometry
+ *
+ * Renderer primitives append colored (or textured) quads here instead of
+ * calling SDL directly. Everything that shares a texture - including "no
+ * texture" for solid fills - is submitted in a single SDL_RenderGeometry
+ * call. The batch flushes itself when the texture changes; the Renderer
+ * flushes it before any direct SDL call and at present().
+ */
+class DrawBatch {
+public:
+    explicit DrawBatch(SDL_Renderer* sdlRenderer);
+
+    // Non-copyable
+    DrawBatch(const DrawBatch&) = delete;
+    DrawBatch& operator=(const DrawBatch&) = delete;
+
+    // Solid axis-aligned rectangle covering [x, x + w) x [y, y + h)
+    void addRect(float x, float y, float w, float h, const SDL_Color& color);
+
+    // Solid arbitrary quad, corners in winding order
+    void addQuad(const SDL_FPoint (&corners)[4], const SDL_Color& color);
+
+    // Textured rectangle; uv is in normalized texture coordinates
+    void addTexturedRect(SDL_Texture* texture, const SDL_FRect& dest, const SDL_FRect& uv,
+                         const SDL_Color& color);
+
+    // Translation added to every vertex queued from now on
+    void setOffset(float x, float y) { offsetX = x; offsetY = y; }
+
+    // Write solid fills with alpha 255. Used when drawing into a layer
+    // texture with no draw blending: on screen those fills replace the
+    // pixel outright, so the layer texel must be opaque to do the same.
+    void setForceOpaque(bool enabled) { forceOpaque = enabled; }
+
+    // Submit everything queued so far
+    void flush();
+
+    bool isEmpty() const { return indices.empty(); }
+
+    // Number of SDL_RenderGeometry calls issued (for diagnostics)
+    unsigned int getFlushCount() const { return flushCount; }
+
+private:
+    static constexpr size_t INITIAL_VERTEX_CAPACITY = 4096;
+
+    SDL_Renderer* sdlRenderer;
+    SDL_Texture* currentTexture;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    unsigned int flushCount;
+    float offsetX;
+    float offsetY;
+    bool forceOpaque;
+
+    SDL_Color solidColor(const SDL_Color& color) const;
+    void useTexture(SDL_Texture* texture);
+    void pushQuadIndices();
+};
+
+} // namespace AOS
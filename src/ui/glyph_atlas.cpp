@@ -0,0 +1,284 @@
+#include "glyph_atlas.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "draw_batch.h"
+#include "renderer.h"
+#include "os/tracer.h"
+
+namespace AOS {
+
+namespace {
+
+constexpr int ATLAS_SIZE_SMALL = 512;
+constexpr int ATLAS_SIZE_LARGE = 1024;
+constexpr int LARGE_FONT_THRESHOLD = 32;
+constexpr int GLYPH_PADDING = 1;
+constexpr Uint16 REPLACEMENT_GLYPH = '?';
+
+// Decode one UTF-8 sequence starting at text[i] and advance i past it.
+// Bytes that are not valid UTF-8 are treated as Latin-1, which is what
+// TTF_RenderText_* used to assume. Characters outside the BMP map to '?'.
+Uint16 nextCodepoint(const std::string& text, size_t& i) {
+    const unsigned char lead = static_cast<unsigned char>(text[i]);
+
+    int length = 1;
+    Uint32 codepoint = lead;
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        codepoint = lead & 0x07;
+    } else if (lead >= 0xE0) {
+        length = 3;
+        codepoint = lead & 0x0F;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        codepoint = lead & 0x1F;
+    }
+
+    if (length > 1) {
+        if (i + length > text.size()) {
+            length = 1;
+            codepoint = lead;
+        } else {
+            for (int k = 1; k < length; ++k) {
+                const unsigned char cont = static_cast<unsigned char>(text[i + k]);
+                if ((cont & 0xC0) != 0x80) {
+                    length = 1;
+                    codepoint = lead;
+                    break;
+                }
+                codepoint = (codepoint << 6) | (cont & 0x3F);
+            }
+        }
+    }
+
+    i += length;
+    return codepoint > 0xFFFF ? REPLACEMENT_GLYPH : static_cast<Uint16>(codepoint);
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer* sdlRend, DrawBatch& drawBatch, TTF_Font* ttfFont, int fontSize)
+    : sdlRenderer(sdlRend)
+    , batch(drawBatch)
+    , font(ttfFont)
+    , texture(nullptr)
+    , atlasSize(fontSize > LARGE_FONT_THRESHOLD ? ATLAS_SIZE_LARGE : ATLAS_SIZE_SMALL)
+    , packX(0)
+    , packY(0)
+    , shelfHeight(0)
+    , asciiGlyphs()
+    , kerningEnabled(TTF_GetFontKerning(ttfFont) != 0)
+    , rasterizedGlyphs(0)
+    , rebuilds(0)
+{
+    texture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888,
+                                SDL_TEXTUREACCESS_STATIC, atlasSize, atlasSize);
+    if (!texture) {
+        std::cerr << "GlyphAtlas: SDL_CreateTexture failed: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    // Static textures start with undefined contents; clear once so padding is transparent
+    std::vector<Uint32> blank(static_cast<size_t>(atlasSize) * atlasSize, 0);
+    SDL_UpdateTexture(texture, nullptr, blank.data(), atlasSize * static_cast<int>(sizeof(Uint32)));
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void GlyphAtlas::drawText(const std::string& text, int x, int y, const Color& color) {
+    if (!texture || text.empty()) {
+        return;
+    }
+
+    const SDL_Color vertexColor = { color.r, color.g, color.b, color.a };
+    const float invSize = 1.0f / static_cast<float>(atlasSize);
+
+    int cursorX = x;
+    Uint16 previous = 0;
+    bool first = true;
+
+    for (size_t i = 0; i < text.size();) {
+        const Uint16 codepoint = nextCodepoint(text, i);
+        const Glyph* glyph = getGlyph(codepoint);
+        if (!glyph) {
+            continue;
+        }
+
+        if (first) {
+            // TTF_RenderText shifts the whole line right when the first glyph
+            // has a negative left bearing; mirror that so layouts don't move
+            cursorX -= glyph->offsetX;
+            first = false;
+        } else {
+            cursorX += getKerning(previous, codepoint);
+        }
+        previous = codepoint;
+
+        if (glyph->src.w > 0 && glyph->src.h > 0) {
+            const SDL_FRect dest = {
+                static_cast<float>(cursorX + glyph->offsetX), static_cast<float>(y),
+                static_cast<float>(glyph->src.w), static_cast<float>(glyph->src.h)
+            };
+            const SDL_FRect uv = {
+                glyph->src.x * invSize, glyph->src.y * invSize,
+                glyph->src.w * invSize, glyph->src.h * invSize
+            };
+            batch.addTexturedRect(texture, dest, uv, vertexColor);
+        }
+
+        cursorX += glyph->advance;
+    }
+}
+
+int GlyphAtlas::measureText(const std::string& text) {
+    int width = 0;
+    Uint16 previous = 0;
+    bool first = true;
+
+    for (size_t i = 0; i < text.size();) {
+        const Uint16 codepoint = nextCodepoint(text, i);
+        const Glyph* glyph = getGlyph(codepoint);
+        if (!glyph) {
+            continue;
+        }
+
+        if (!first) {
+            width += getKerning(previous, codepoint);
+        }
+        first = false;
+        previous = codepoint;
+        width += glyph->advance;
+    }
+
+    return width;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::getGlyph(Uint16 codepoint) {
+    Glyph* glyph = nullptr;
+    if (codepoint < ASCII_GLYPHS) {
+        glyph = &asciiGlyphs[codepoint];
+    } else {
+        glyph = &extendedGlyphs[codepoint];
+    }
+
+    if (glyph->loaded) {
+        return glyph;
+    }
+
+    // Characters the font doesn't cover fall back to '?' like SDL_ttf does
+    if (codepoint != REPLACEMENT_GLYPH && !TTF_GlyphIsProvided(font, codepoint)) {
+        return getGlyph(REPLACEMENT_GLYPH);
+    }
+
+    if (!rasterizeGlyph(codepoint, *glyph)) {
+        // Atlas is full. Quads already queued still point at the old layout,
+        // so submit them before wiping the atlas.
+        batch.flush();
+
+        reset();
+
+        // reset() may have rehashed extendedGlyphs, so look the slot up again
+        glyph = codepoint < ASCII_GLYPHS ? &asciiGlyphs[codepoint] : &extendedGlyphs[codepoint];
+        if (!rasterizeGlyph(codepoint, *glyph)) {
+            // Larger than the whole atlas: keep the advance, skip the bitmap
+            glyph->loaded = true;
+        }
+    }
+
+    return glyph;
+}
+
+bool GlyphAtlas::rasterizeGlyph(Uint16 codepoint, Glyph& glyph) {
+    int minX = 0, maxX = 0, minY = 0, maxY = 0, advance = 0;
+    TTF_GlyphMetrics(font, codepoint, &minX, &maxX, &minY, &maxY, &advance);
+
+    glyph.src = { 0, 0, 0, 0 };
+    glyph.offsetX = std::min(0, minX);
+    glyph.advance = advance;
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(font, codepoint, white);
+    if (!surface) {
+        std::cerr << "GlyphAtlas: TTF_RenderGlyph_Blended failed: " << TTF_GetError() << std::endl;
+        glyph.loaded = true;
+        return true;
+    }
+
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+        if (!surface) {
+            std::cerr << "GlyphAtlas: SDL_ConvertSurfaceFormat failed: " << SDL_GetError() << std::endl;
+            glyph.loaded = true;
+            return true;
+        }
+    }
+
+    const int w = surface->w;
+    const int h = surface->h;
+
+    // Shelf packing: fill rows left to right, open a new row when full
+    if (packX + w + GLYPH_PADDING > atlasSize) {
+        packX = 0;
+        packY += shelfHeight + GLYPH_PADDING;
+        shelfHeight = 0;
+    }
+    if (packY + h + GLYPH_PADDING > atlasSize || w + GLYPH_PADDING > atlasSize) {
+        SDL_FreeSurface(surface);
+        return false;
+    }
+
+    SDL_Rect dest = { packX, packY, w, h };
+    SDL_UpdateTexture(texture, &dest, surface->pixels, surface->pitch);
+    SDL_FreeSurface(surface);
+
+    glyph.src = dest;
+    glyph.loaded = true;
+
+    packX += w + GLYPH_PADDING;
+    shelfHeight = std::max(shelfHeight, h);
+    rasterizedGlyphs++;
+
+    return true;
+}
+
+int GlyphAtlas::getKerning(Uint16 previous, Uint16 current) {
+    if (!kerningEnabled) {
+        return 0;
+    }
+
+    const Uint32 key = (static_cast<Uint32>(previous) << 16) | current;
+    auto it = kerningCache.find(key);
+    if (it != kerningCache.end()) {
+        return it->second;
+    }
+
+    int kerning = TTF_GetFontKerningSizeGlyphs(font, previous, current);
+    kerningCache.emplace(key, kerning);
+    return kerning;
+}
+
+void GlyphAtlas::reset() {
+    AOS_TRACE_INSTANT("Glyph atlas rebuilt", "render", nullptr);
+    rebuilds++;
+
+    for (auto& glyph : asciiGlyphs) {
+        glyph.loaded = false;
+    }
+    extendedGlyphs.clear();
+
+    packX = 0;
+    packY = 0;
+    shelfHeight = 0;
+}
+
+} // namespace AOS
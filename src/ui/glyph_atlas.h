@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace AOS {
+
+struct Color;
+class DrawBatch;
+
+/**
+ * GlyphAtlas - Lazily filled glyph texture for one (font, size) pair
+ *
+ * Glyphs are rasterized once with SDL_ttf (white, so vertex colors can tint
+ * them) and packed into a single static texture using a simple shelf packer.
+ * Advance and kerning metrics are cached alongside, so drawing a string is
+ * just appending textured quads to the Renderer's DrawBatch - no texture
+ * creation in steady state.
+ *
+ * When the atlas fills up it is wiped and refilled on demand; that only
+ * happens if an app cycles through far more distinct glyphs than fit
+ * (counted in getRebuildCount()).
+ */
+class GlyphAtlas {
+public:
+    GlyphAtlas(SDL_Renderer* sdlRenderer, DrawBatch& batch, TTF_Font* font, int fontSize);
+    ~GlyphAtlas();
+
+    // Non-copyable (owns an SDL texture)
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    // Check if the atlas texture was created successfully
+    bool isValid() const { return texture != nullptr; }
+
+    // Draw UTF-8 text with its top-left corner at (x, y)
+    void drawText(const std::string& text, int x, int y, const Color& color);
+
+    // Width in pixels that drawText would cover
+    int measureText(const std::string& text);
+
+    // Number of glyphs rasterized so far (for diagnostics)
+    size_t getRasterizedGlyphCount() const { return rasterizedGlyphs; }
+
+    // Number of times the atlas filled up and was wiped
+    size_t getRebuildCount() const { return rebuilds; }
+
+private:
+    struct Glyph {
+        SDL_Rect src;       // Region inside the atlas texture
+        int offsetX;        // Horizontal offset of the bitmap relative to the pen
+        int advance;        // Pen advance after this glyph
+        bool loaded;
+    };
+
+    SDL_Renderer* sdlRenderer;
+    DrawBatch& batch;
+    TTF_Font* font;
+    SDL_Texture* texture;
+    int atlasSize;
+
+    // Shelf packer state
+    int packX;
+    int packY;
+    int shelfHeight;
+
+    // Glyph cache: ASCII is a flat table, everything else is hashed
+    static constexpr int ASCII_GLYPHS = 128;
+    Glyph asciiGlyphs[ASCII_GLYPHS];
+    std::unordered_map<Uint16, Glyph> extendedGlyphs;
+    std::unordered_map<Uint32, int> kerningCache;
+    bool kerningEnabled;
+    size_t rasterizedGlyphs;
+    size_t rebuilds;
+
+    const Glyph* getGlyph(Uint16 codepoint);
+    bool rasterizeGlyph(Uint16 codepoint, Glyph& glyph);
+    int getKerning(Uint16 previous, Uint16 current);
+    void reset();
+};
+
+} // namespace AOS
@@ -0,0 +1,191 @@
+#include "gradient_cache.h"
+
+#include <iostream>
+#include <vector>
+
+#include "circle_cache.h"
+#include "renderer.h"
+#include "os/tracer.h"
+
+namespace AOS {
+
+namespace {
+
+constexpr int BYTES_PER_PIXEL = 4;
+
+// Same interpolation drawGradientRect/drawRadialGradient always used
+uint8_t lerpChannel(uint8_t from, uint8_t to, float t) {
+    return (uint8_t)(from + t * (to - from));
+}
+
+// Non-premultiplied "over": what SDL_BLENDMODE_BLEND does when layers are
+// drawn one after another, folded into a single texel
+void blendOver(uint8_t* dst, const uint8_t* src) {
+    const float srcA = src[3] / 255.0f;
+    const float dstA = dst[3] / 255.0f;
+    const float outA = srcA + dstA * (1.0f - srcA);
+    if (outA <= 0.0f) {
+        return;
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        const float value = (src[c] * srcA + dst[c] * dstA * (1.0f - srcA)) / outA;
+        dst[c] = static_cast<uint8_t>(value + 0.5f);
+    }
+    dst[3] = static_cast<uint8_t>(outA * 255.0f + 0.5f);
+}
+
+} // namespace
+
+size_t GradientCache::KeyHash::operator()(const Key& key) const {
+    uint64_t hash = (static_cast<uint64_t>(key.first) << 32) | key.second;
+    hash ^= (static_cast<uint64_t>(key.size) << 8) ^ (static_cast<uint64_t>(key.kind) << 4) ^
+            static_cast<uint64_t>(key.blendMode);
+    hash *= 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+GradientCache::GradientCache(SDL_Renderer* sdlRend)
+    : sdlRenderer(sdlRend)
+    , frameIndex(0)
+    , bytesUsed(0)
+    , texturesCreated(0)
+{
+}
+
+GradientCache::~GradientCache() {
+    clear();
+}
+
+SDL_Texture* GradientCache::getLinear(const Color& top, const Color& bottom, int height,
+                                      SDL_BlendMode blendMode) {
+    const Key key = { Kind::Linear, blendMode, top.toRGBA(), bottom.toRGBA(), height };
+    if (SDL_Texture* texture = lookup(key)) {
+        return texture;
+    }
+
+    AOS_TRACE_ZONE("GradientCache::bakeLinear", "render");
+    std::vector<uint8_t> pixels(static_cast<size_t>(height) * BYTES_PER_PIXEL);
+    for (int y = 0; y < height; ++y) {
+        float t = (float)y / (float)height;
+        uint8_t* texel = &pixels[static_cast<size_t>(y) * BYTES_PER_PIXEL];
+        texel[0] = lerpChannel(top.r, bottom.r, t);
+        texel[1] = lerpChannel(top.g, bottom.g, t);
+        texel[2] = lerpChannel(top.b, bottom.b, t);
+        texel[3] = lerpChannel(top.a, bottom.a, t);
+    }
+
+    // Rows were drawn with the draw blend mode; copy texels the same way
+    return store(key, pixels.data(), 1, height, blendMode);
+}
+
+SDL_Texture* GradientCache::getRadial(const Color& center, const Color& edge, int radius,
+                                      SDL_BlendMode blendMode, CircleCache& circles) {
+    const Key key = { Kind::Radial, blendMode, center.toRGBA(), edge.toRGBA(), radius };
+    if (SDL_Texture* texture = lookup(key)) {
+        return texture;
+    }
+
+    AOS_TRACE_ZONE("GradientCache::bakeRadial", "render");
+    const int size = 2 * radius + 1;
+    std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * BYTES_PER_PIXEL, 0);
+
+    int steps = radius / 2;
+    if (steps < 10) steps = 10;
+    if (steps > 50) steps = 50;
+
+    // Replay the nested discs, outermost first, into the texture
+    for (int i = steps; i > 0; --i) {
+        float t = (float)i / (float)steps;
+        int currentRadius = (int)(radius * t);
+
+        uint8_t color[4] = {
+            lerpChannel(center.r, edge.r, t),
+            lerpChannel(center.g, edge.g, t),
+            lerpChannel(center.b, edge.b, t),
+            lerpChannel(center.a, edge.a, t)
+        };
+
+        // Without blending each disc simply overwrote the last, and its
+        // alpha never affected the window. Bake it opaque and let the
+        // transparent corners be the only see-through texels.
+        if (blendMode == SDL_BLENDMODE_NONE) {
+            color[3] = 255;
+        }
+
+        for (const SDL_Rect& span : circles.get(currentRadius).fill) {
+            for (int row = 0; row < span.h; ++row) {
+                const int y = radius + span.y + row;
+                uint8_t* texel = &pixels[(static_cast<size_t>(y) * size + radius + span.x) * BYTES_PER_PIXEL];
+                for (int col = 0; col < span.w; ++col, texel += BYTES_PER_PIXEL) {
+                    if (blendMode == SDL_BLENDMODE_NONE) {
+                        texel[0] = color[0];
+                        texel[1] = color[1];
+                        texel[2] = color[2];
+                        texel[3] = color[3];
+                    } else {
+                        blendOver(texel, color);
+                    }
+                }
+            }
+        }
+    }
+
+    // The disc edges need real transparency regardless of draw blend mode
+    return store(key, pixels.data(), size, size, SDL_BLENDMODE_BLEND);
+}
+
+void GradientCache::endFrame() {
+    frameIndex++;
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (frameIndex - it->second.lastUsedFrame > EVICT_AFTER_FRAMES) {
+            SDL_DestroyTexture(it->second.texture);
+            bytesUsed -= it->second.bytes;
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GradientCache::clear() {
+    for (auto& pair : entries) {
+        SDL_DestroyTexture(pair.second.texture);
+    }
+    entries.clear();
+    bytesUsed = 0;
+}
+
+SDL_Texture* GradientCache::lookup(const Key& key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+
+    it->second.lastUsedFrame = frameIndex;
+    return it->second.texture;
+}
+
+SDL_Texture* GradientCache::store(const Key& key, const uint8_t* pixels, int width, int height,
+                                  SDL_BlendMode textureBlend) {
+    SDL_Texture* texture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGBA32,
+                                             SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        std::cerr << "GradientCache: SDL_CreateTexture failed: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_UpdateTexture(texture, nullptr, pixels, width * BYTES_PER_PIXEL);
+    SDL_SetTextureBlendMode(texture, textureBlend);
+    SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+
+    const size_t bytes = static_cast<size_t>(width) * height * BYTES_PER_PIXEL;
+    texturesCreated++;
+    entries[key] = { texture, frameIndex, bytes };
+    bytesUsed += bytes;
+
+    return texture;
+}
+
+} // namespace AOS
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <unordered_map>
+
+namespace AOS {
+
+struct Color;
+class CircleCache;
+
+/**
+ * GradientCache - Pre-baked gradient textures
+ *
+ * drawGradientRect used to issue one line per pixel row and
+ * drawRadialGradient up to 50 nested discs. Both depend only on their
+ * colors and size, so the result is baked once into a texture and then
+ * stretched/copied with a single quad:
+ * - Linear: a 1 x height texture, stretched horizontally
+ * - Radial: a (2r + 1)^2 texture with the nested discs composited
+ *
+ * Textures are baked for the renderer's current draw blend mode so the
+ * output matches the per-primitive path. Entries that go unused for
+ * EVICT_AFTER_FRAMES frames are destroyed in endFrame().
+ */
+class GradientCache {
+public:
+    static constexpr uint32_t EVICT_AFTER_FRAMES = 120;
+
+    explicit GradientCache(SDL_Renderer* sdlRenderer);
+    ~GradientCache();
+
+    // Non-copyable (owns SDL textures)
+    GradientCache(const GradientCache&) = delete;
+    GradientCache& operator=(const GradientCache&) = delete;
+
+    // Vertical gradient, one texel per row. Returns nullptr on failure.
+    SDL_Texture* getLinear(const Color& top, const Color& bottom, int height, SDL_BlendMode blendMode);
+
+    // Nested-disc radial gradient, (2 * radius + 1) texels square
+    SDL_Texture* getRadial(const Color& center, const Color& edge, int radius, SDL_BlendMode blendMode,
+                           CircleCache& circles);
+
+    // Advance the frame clock and evict stale entries
+    void endFrame();
+
+    // Destroy all textures
+    void clear();
+
+    size_t getEntryCount() const { return entries.size(); }
+    uint64_t getTexturesCreated() const { return texturesCreated; }
+    size_t getBytesUsed() const { return bytesUsed; }
+
+private:
+    enum class Kind : uint8_t { Linear, Radial };
+
+    struct Key {
+        Kind kind;
+        SDL_BlendMode blendMode;
+        uint32_t first;
+        uint32_t second;
+        int size;
+
+        bool operator==(const Key& other) const {
+            return kind == other.kind && blendMode == other.blendMode &&
+                   first == other.first && second == other.second && size == other.size;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        SDL_Texture* texture;
+        uint32_t lastUsedFrame;
+        size_t bytes;
+    };
+
+    SDL_Renderer* sdlRenderer;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    uint32_t frameIndex;
+    size_t bytesUsed;
+    uint64_t texturesCreated;
+
+    SDL_Texture* lookup(const Key& key);
+    SDL_Texture* store(const Key& key, const uint8_t* pixels, int width, int height, SDL_BlendMode textureBlend);
+};
+
+} // namespace AOS
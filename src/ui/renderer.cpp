@@ -1,15 +1,61 @@
 #include "renderer.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include "glyph_atlas.h"
+#include "os/tracer.h"
 
 namespace AOS {
 
+namespace {
+
+constexpr int SHADOW_CORNER_RADIUS = 12;
+
+SDL_Color toSDLColor(const Color& color) {
+    return { color.r, color.g, color.b, color.a };
+}
+
+// Layers are drawn into from transparent black with ordinary blending,
+// which leaves premultiplied color in them
+SDL_BlendMode premultipliedBlendMode() {
+    static const SDL_BlendMode mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    return mode;
+}
+
+Rect intersectRects(const Rect& a, const Rect& b) {
+    const int x1 = std::max(a.x, b.x);
+    const int y1 = std::max(a.y, b.y);
+    const int x2 = std::min(a.x + a.w, b.x + b.w);
+    const int y2 = std::min(a.y + a.h, b.y + b.h);
+    return Rect(x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0));
+}
+
+} // namespace
+
 Renderer::Renderer(SDL_Window* win, SDL_Renderer* sdlRend)
     : window(win)
     , sdlRenderer(sdlRend)
+    , retainedFrame(nullptr)
+    , drawingToRetainedFrame(false)
+    , retainedFrameCurrent(false)
+    , translateX(0)
+    , translateY(0)
+    , layerStats{0, 0}
+    , ownCounters{0, 0, 0}
+    , counterBaseline{0, 0, 0}
     , defaultFontPath("")
+    , batch(sdlRend)
+    , gradientCache(sdlRend)
+    , shadowCache(sdlRend)
+    , frameIndex(0)
 {
-    SDL_GetWindowSize(window, &screenWidth, &screenHeight);
+    if (window) {
+        SDL_GetWindowSize(window, &screenWidth, &screenHeight);
+    } else {
+        SDL_GetRendererOutputSize(sdlRenderer, &screenWidth, &screenHeight);
+    }
     std::cout << "Renderer initialized: " << screenWidth << "x" << screenHeight << std::endl;
 
     // Initialize SDL_ttf
@@ -21,6 +67,13 @@ Renderer::Renderer(SDL_Window* win, SDL_Renderer* sdlRend)
 }
 
 Renderer::~Renderer() {
+    // Cached textures reference fonts and the SDL renderer, so they go first
+    textCache.clear();
+    gradientCache.clear();
+    shadowCache.clear();
+    glyphAtlases.clear();
+    setRetainedFrame(false);
+
     // Free all cached fonts
     for (auto& pair : fontCache) {
         if (pair.second) {
@@ -34,23 +87,343 @@ Renderer::~Renderer() {
 }
 
 void Renderer::clear(const Color& color) {
+    batch.flush();
     SDL_SetRenderDrawColor(sdlRenderer, color.r, color.g, color.b, color.a);
     SDL_RenderClear(sdlRenderer);
 }
 
 void Renderer::present() {
-    SDL_RenderPresent(sdlRenderer);
+    AOS_TRACE_ZONE("Renderer::present", "render");
+    batch.flush();
+
+    if (drawingToRetainedFrame) {
+        // Copy the composed frame to the window, then keep drawing into it
+        SDL_SetRenderTarget(sdlRenderer, nullptr);
+        SDL_RenderCopy(sdlRenderer, retainedFrame, nullptr, nullptr);
+        ownCounters.drawCalls++;
+        SDL_RenderPresent(sdlRenderer);
+        SDL_SetRenderTarget(sdlRenderer, retainedFrame);
+        retainedFrameCurrent = true;
+    } else {
+        SDL_RenderPresent(sdlRenderer);
+        retainedFrameCurrent = false;
+    }
+
+    frameIndex++;
+    gradientCache.endFrame();
+    shadowCache.endFrame();
+}
+
+void Renderer::flush() {
+    batch.flush();
+}
+
+void Renderer::beginFrame(bool useRetainedFrame) {
+    const bool retained = useRetainedFrame && retainedFrame != nullptr;
+    if (retained == drawingToRetainedFrame) {
+        return;
+    }
+
+    batch.flush();
+    SDL_SetRenderTarget(sdlRenderer, retained ? retainedFrame : nullptr);
+    drawingToRetainedFrame = retained;
+}
+
+void Renderer::handleResize() {
+    int width = 0;
+    int height = 0;
+    if (window) {
+        SDL_GetWindowSize(window, &width, &height);
+    } else {
+        SDL_GetRendererOutputSize(sdlRenderer, &width, &height);
+    }
+    if (width == screenWidth && height == screenHeight) {
+        return;
+    }
+
+    screenWidth = width;
+    screenHeight = height;
+    std::cout << "Renderer resized: " << screenWidth << "x" << screenHeight << std::endl;
+
+    if (retainedFrame) {
+        const bool wasDrawingToIt = drawingToRetainedFrame;
+        setRetainedFrame(false);
+        if (setRetainedFrame(true)) {
+            beginFrame(wasDrawingToIt);
+        }
+    }
+}
+
+RenderCounters Renderer::getCounters() const {
+    RenderCounters total = totalCounters();
+    return {
+        total.drawCalls - counterBaseline.drawCalls,
+        total.textureCreations - counterBaseline.textureCreations,
+        total.textRasterizations - counterBaseline.textRasterizations
+    };
+}
+
+void Renderer::resetCounters() {
+    counterBaseline = totalCounters();
+}
+
+RenderCounters Renderer::totalCounters() const {
+    RenderCounters total = ownCounters;
+    total.drawCalls += batch.getFlushCount();
+    total.textureCreations += gradientCache.getTexturesCreated() + shadowCache.getTexturesCreated();
+    for (const auto& pair : glyphAtlases) {
+        if (pair.second) {
+            total.textRasterizations += pair.second->getRasterizedGlyphCount();
+        }
+    }
+    return total;
+}
+
+uint64_t Renderer::getGlyphAtlasRebuilds() const {
+    uint64_t rebuilds = 0;
+    for (const auto& pair : glyphAtlases) {
+        if (pair.second) {
+            rebuilds += pair.second->getRebuildCount();
+        }
+    }
+    return rebuilds;
+}
+
+bool Renderer::saveFrame(const std::string& path) {
+    batch.flush();
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, screenWidth, screenHeight, 32,
+                                                          SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        std::cerr << "Renderer: failed to create frame surface: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    bool saved = SDL_RenderReadPixels(sdlRenderer, nullptr, SDL_PIXELFORMAT_ARGB8888,
+                                      surface->pixels, surface->pitch) == 0 &&
+                 SDL_SaveBMP(surface, path.c_str()) == 0;
+    if (!saved) {
+        std::cerr << "Renderer: failed to save frame " << path << ": " << SDL_GetError() << std::endl;
+    }
+
+    SDL_FreeSurface(surface);
+    return saved;
+}
+
+bool Renderer::setRetainedFrame(bool enabled) {
+    batch.flush();
+
+    if (!enabled) {
+        if (retainedFrame) {
+            SDL_SetRenderTarget(sdlRenderer, nullptr);
+            SDL_DestroyTexture(retainedFrame);
+            retainedFrame = nullptr;
+        }
+        drawingToRetainedFrame = false;
+        retainedFrameCurrent = false;
+        return true;
+    }
+
+    if (retainedFrame) {
+        return true;
+    }
+
+    if (!SDL_RenderTargetSupported(sdlRenderer)) {
+        std::cerr << "Renderer: render targets not supported, no retained frame" << std::endl;
+        return false;
+    }
+
+    retainedFrame = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                      screenWidth, screenHeight);
+    if (!retainedFrame) {
+        std::cerr << "Renderer: failed to create retained frame: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    ownCounters.textureCreations++;
+
+    // The copy to the window must replace, not blend
+    SDL_SetTextureBlendMode(retainedFrame, SDL_BLENDMODE_NONE);
+
+    if (SDL_SetRenderTarget(sdlRenderer, retainedFrame) != 0) {
+        std::cerr << "Renderer: failed to target retained frame: " << SDL_GetError() << std::endl;
+        SDL_DestroyTexture(retainedFrame);
+        retainedFrame = nullptr;
+        return false;
+    }
+
+    // Empty until a frame has been drawn into it
+    drawingToRetainedFrame = true;
+    retainedFrameCurrent = false;
+    return true;
+}
+
+void Renderer::setClipRect(const Rect& rect) {
+    clipStack.assign(1, Rect(rect.x + translateX, rect.y + translateY, rect.w, rect.h));
+    applyClip();
+}
+
+void Renderer::clearClipRect() {
+    clipStack.clear();
+    applyClip();
+}
+
+void Renderer::pushClipRect(const Rect& rect) {
+    Rect clip(rect.x + translateX, rect.y + translateY, rect.w, rect.h);
+    if (!clipStack.empty()) {
+        clip = intersectRects(clipStack.back(), clip);
+    }
+    clipStack.push_back(clip);
+    applyClip();
+}
+
+void Renderer::popClipRect() {
+    if (clipStack.empty()) {
+        std::cerr << "Renderer: popClipRect without matching push" << std::endl;
+        return;
+    }
+    clipStack.pop_back();
+    applyClip();
+}
+
+void Renderer::pushTranslate(int dx, int dy) {
+    translateStack.push_back({ translateX, translateY });
+    translateX += dx;
+    translateY += dy;
+    applyTranslate();
+}
+
+void Renderer::popTranslate() {
+    if (translateStack.empty()) {
+        std::cerr << "Renderer: popTranslate without matching push" << std::endl;
+        return;
+    }
+    translateX = translateStack.back().x;
+    translateY = translateStack.back().y;
+    translateStack.pop_back();
+    applyTranslate();
+}
+
+SDL_Texture* Renderer::createLayer(int width, int height) {
+    if (width <= 0 || height <= 0 || !SDL_RenderTargetSupported(sdlRenderer)) {
+        return nullptr;
+    }
+
+    SDL_Texture* layer = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                           width, height);
+    if (!layer) {
+        std::cerr << "Renderer: failed to create layer: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    SDL_SetTextureScaleMode(layer, SDL_ScaleModeNearest);
+    ownCounters.textureCreations++;
+    return layer;
+}
+
+void Renderer::destroyLayer(SDL_Texture* layer) {
+    // Queued quads may still reference it
+    batch.flush();
+    SDL_DestroyTexture(layer);
+}
+
+bool Renderer::beginLayer(SDL_Texture* layer, int originX, int originY) {
+    batch.flush();
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(sdlRenderer);
+    if (SDL_SetRenderTarget(sdlRenderer, layer) != 0) {
+        std::cerr << "Renderer: failed to target layer: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    layerStack.push_back({ previousTarget, translateX, translateY, std::move(clipStack) });
+    layerStats.redraws++;
+
+    translateX = -originX;
+    translateY = -originY;
+    clipStack.clear();
+    applyTranslate();
+    applyClip();
+
+    SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 0);
+    SDL_RenderClear(sdlRenderer);
+
+    batch.setForceOpaque(getDrawBlendMode() == SDL_BLENDMODE_NONE);
+    return true;
+}
+
+void Renderer::endLayer() {
+    if (layerStack.empty()) {
+        std::cerr << "Renderer: endLayer without matching beginLayer" << std::endl;
+        return;
+    }
+
+    batch.flush();
+
+    LayerState& state = layerStack.back();
+    SDL_SetRenderTarget(sdlRenderer, state.previousTarget);
+    translateX = state.translateX;
+    translateY = state.translateY;
+    clipStack = std::move(state.clipStack);
+    layerStack.pop_back();
+
+    applyTranslate();
+    applyClip();
+    batch.setForceOpaque(!layerStack.empty() && getDrawBlendMode() == SDL_BLENDMODE_NONE);
+}
+
+void Renderer::drawLayer(SDL_Texture* layer, const Rect& dest, bool opaque) {
+    if (!layer) {
+        return;
+    }
+
+    // The blend mode is read when the batch is submitted
+    batch.flush();
+    SDL_SetTextureBlendMode(layer, opaque ? SDL_BLENDMODE_NONE : premultipliedBlendMode());
+
+    const SDL_FRect target = { (float)dest.x, (float)dest.y, (float)dest.w, (float)dest.h };
+    batch.addTexturedRect(layer, target, { 0.0f, 0.0f, 1.0f, 1.0f }, toSDLColor(Color::White()));
+    layerStats.composites++;
+}
+
+void Renderer::applyTranslate() {
+    batch.setOffset((float)translateX, (float)translateY);
+}
+
+void Renderer::applyClip() {
+    batch.flush();
+    if (clipStack.empty()) {
+        SDL_RenderSetClipRect(sdlRenderer, nullptr);
+        return;
+    }
+
+    const Rect& top = clipStack.back();
+    SDL_Rect clip = { top.x, top.y, top.w, top.h };
+    SDL_RenderSetClipRect(sdlRenderer, &clip);
 }
 
 void Renderer::drawRect(const Rect& rect, const Color& color, bool filled) {
-    SDL_SetRenderDrawColor(sdlRenderer, color.r, color.g, color.b, color.a);
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
 
-    SDL_Rect sdlRect = { rect.x, rect.y, rect.w, rect.h };
+    const SDL_Color sdlColor = toSDLColor(color);
 
     if (filled) {
-        SDL_RenderFillRect(sdlRenderer, &sdlRect);
-    } else {
-        SDL_RenderDrawRect(sdlRenderer, &sdlRect);
+        batch.addRect(rect.x, rect.y, rect.w, rect.h, sdlColor);
+        return;
+    }
+
+    // One-pixel outline, same pixels SDL_RenderDrawRect would touch
+    batch.addRect(rect.x, rect.y, rect.w, 1, sdlColor);
+    if (rect.h > 1) {
+        batch.addRect(rect.x, rect.y + rect.h - 1, rect.w, 1, sdlColor);
+    }
+    if (rect.h > 2) {
+        batch.addRect(rect.x, rect.y + 1, 1, rect.h - 2, sdlColor);
+        if (rect.w > 1) {
+            batch.addRect(rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2, sdlColor);
+        }
     }
 }
 
@@ -67,12 +440,62 @@ void Renderer::drawText(const std::string& text, int x, int y, const Color& colo
         return;
     }
 
+    // Textured quads from the glyph atlas for this size, batched with
+    // everything else
+    GlyphAtlas* atlas = getGlyphAtlas(fontSize);
+    if (atlas) {
+        atlas->drawText(text, x, y, color);
+        return;
+    }
+
+    // No atlas: strings drawn on previous frames are usually still cached
+    const uint64_t key = TextCache::makeKey(text, fontSize, color);
+    const TextCache::Entry* cached = textCache.find(key, text, fontSize, color);
+
+    if (!cached && textCache.shouldAdmit(key, frameIndex)) {
+        int width = 0;
+        int height = 0;
+        SDL_Texture* texture = rasterizeText(font, text, color, width, height);
+        if (texture) {
+            cached = textCache.insert(key, text, fontSize, color, texture, width, height);
+            if (!cached) {
+                SDL_DestroyTexture(texture);  // Larger than the whole budget
+            }
+        }
+    }
+
+    if (cached) {
+        batch.flush();
+        SDL_Rect destRect = { x + translateX, y + translateY, cached->width, cached->height };
+        SDL_RenderCopy(sdlRenderer, cached->texture, nullptr, &destRect);
+        ownCounters.drawCalls++;
+        return;
+    }
+
+    // Last resort: rasterize and upload just for this call
+    int width = 0;
+    int height = 0;
+    SDL_Texture* texture = rasterizeText(font, text, color, width, height);
+    if (texture) {
+        batch.flush();
+        SDL_Rect destRect = { x + translateX, y + translateY, width, height };
+        SDL_RenderCopy(sdlRenderer, texture, nullptr, &destRect);
+        ownCounters.drawCalls++;
+        SDL_DestroyTexture(texture);
+    }
+}
+
+SDL_Texture* Renderer::rasterizeText(TTF_Font* font, const std::string& text, const Color& color,
+                                     int& width, int& height) {
+    AOS_TRACE_ZONE_DETAIL("rasterizeText", "render", text.c_str());
+
     // Render text to surface
     SDL_Color sdlColor = { color.r, color.g, color.b, color.a };
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), sdlColor);
+    SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text.c_str(), sdlColor);
+    ownCounters.textRasterizations++;
     if (!surface) {
-        std::cerr << "TTF_RenderText_Blended failed: " << TTF_GetError() << std::endl;
-        return;
+        std::cerr << "TTF_RenderUTF8_Blended failed: " << TTF_GetError() << std::endl;
+        return nullptr;
     }
 
     // Create texture from surface
@@ -80,16 +503,39 @@ void Renderer::drawText(const std::string& text, int x, int y, const Color& colo
     if (!texture) {
         std::cerr << "SDL_CreateTextureFromSurface failed: " << SDL_GetError() << std::endl;
         SDL_FreeSurface(surface);
-        return;
+        return nullptr;
     }
 
-    // Draw texture
-    SDL_Rect destRect = { x, y, surface->w, surface->h };
-    SDL_RenderCopy(sdlRenderer, texture, nullptr, &destRect);
-
-    // Cleanup
-    SDL_DestroyTexture(texture);
+    width = surface->w;
+    height = surface->h;
     SDL_FreeSurface(surface);
+    ownCounters.textureCreations++;
+
+    return texture;
+}
+
+GlyphAtlas* Renderer::getGlyphAtlas(int size) {
+    auto it = glyphAtlases.find(size);
+    if (it != glyphAtlases.end()) {
+        return it->second.get();
+    }
+
+    TTF_Font* font = getFont(size);
+    if (!font) {
+        return nullptr;
+    }
+
+    auto atlas = std::make_unique<GlyphAtlas>(sdlRenderer, batch, font, size);
+    if (!atlas->isValid()) {
+        // Remember the failure so we don't retry every frame
+        glyphAtlases[size] = nullptr;
+        return nullptr;
+    }
+
+    GlyphAtlas* result = atlas.get();
+    glyphAtlases[size] = std::move(atlas);
+    ownCounters.textureCreations++;
+    return result;
 }
 
 bool Renderer::loadFont(const std::string& path, int size) {
@@ -151,6 +597,18 @@ TTF_Font* Renderer::getFont(int size) {
 }
 
 void Renderer::drawGradientRect(const Rect& rect, const Color& colorTop, const Color& colorBottom) {
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+
+    // One baked column, stretched across the row span the lines used to cover
+    SDL_Texture* texture = gradientCache.getLinear(colorTop, colorBottom, rect.h, getDrawBlendMode());
+    if (texture) {
+        const SDL_FRect dest = { (float)rect.x, (float)rect.y, (float)(rect.w + 1), (float)rect.h };
+        batch.addTexturedRect(texture, dest, { 0.0f, 0.0f, 1.0f, 1.0f }, toSDLColor(Color::White()));
+        return;
+    }
+
     // Draw vertical gradient line by line
     for (int y = 0; y < rect.h; ++y) {
         float t = (float)y / (float)rect.h;
@@ -160,49 +618,98 @@ void Renderer::drawGradientRect(const Rect& rect, const Color& colorTop, const C
         uint8_t b = (uint8_t)(colorTop.b + t * (colorBottom.b - colorTop.b));
         uint8_t a = (uint8_t)(colorTop.a + t * (colorBottom.a - colorTop.a));
         
-        SDL_SetRenderDrawColor(sdlRenderer, r, g, b, a);
-        SDL_RenderDrawLine(sdlRenderer, rect.x, rect.y + y, rect.x + rect.w, rect.y + y);
+        addLine(rect.x, rect.y + y, rect.x + rect.w, rect.y + y, 1, { r, g, b, a });
     }
 }
 
 void Renderer::drawRoundedRect(const Rect& rect, const Color& color, int radius, bool filled) {
-    SDL_SetRenderDrawColor(sdlRenderer, color.r, color.g, color.b, color.a);
-    
     if (radius <= 0 || radius > rect.w / 2 || radius > rect.h / 2) {
         // Fallback to regular rectangle
         drawRect(rect, color, filled);
         return;
     }
     
+    const SDL_Color sdlColor = toSDLColor(color);
+
     // Draw rounded corners cleanly
     if (filled) {
-        // Center rectangle (horizontal)
-        SDL_Rect centerH = { rect.x, rect.y + radius, rect.w, rect.h - 2 * radius };
-        SDL_RenderFillRect(sdlRenderer, &centerH);
-        
-        // Top and bottom rectangles
-        SDL_Rect topRect = { rect.x + radius, rect.y, rect.w - 2 * radius, radius };
-        SDL_RenderFillRect(sdlRenderer, &topRect);
-        
-        SDL_Rect bottomRect = { rect.x + radius, rect.y + rect.h - radius, rect.w - 2 * radius, radius };
-        SDL_RenderFillRect(sdlRenderer, &bottomRect);
-        
-        // Four corner circles (filled)
-        drawCircle(rect.x + radius, rect.y + radius, radius, color, true);
-        drawCircle(rect.x + rect.w - radius - 1, rect.y + radius, radius, color, true);
-        drawCircle(rect.x + radius, rect.y + rect.h - radius - 1, radius, color, true);
-        drawCircle(rect.x + rect.w - radius - 1, rect.y + rect.h - radius - 1, radius, color, true);
+        // Emit the shape row by row from the corner span table: the union of
+        // the four corner discs, the top/bottom bands and the middle block,
+        // without overdraw. Equal rows merge, so the middle is a single quad.
+        const CircleCache::Table& corner = circleCache.get(radius);
+        const int leftCenter = rect.x + radius;
+        const int rightCenter = rect.x + rect.w - radius - 1;
+        const int topCenter = rect.y + radius;
+        const int bottomCenter = rect.y + rect.h - radius - 1;
+
+        auto rowExtent = [&](int row, int& lo, int& hi) {
+            int halfWidth = -1;
+            if (std::abs(row - topCenter) <= radius) {
+                halfWidth = corner.halfWidth(row - topCenter);
+            }
+            if (std::abs(row - bottomCenter) <= radius) {
+                halfWidth = std::max(halfWidth, corner.halfWidth(row - bottomCenter));
+            }
+            lo = std::min(leftCenter, rightCenter) - halfWidth;
+            hi = std::max(leftCenter, rightCenter) + halfWidth;
+
+            if (row >= rect.y + radius && row < rect.y + rect.h - radius) {
+                lo = std::min(lo, rect.x);
+                hi = std::max(hi, rect.x + rect.w - 1);
+            } else if (row >= rect.y && row < rect.y + rect.h && rect.w > 2 * radius) {
+                lo = std::min(lo, rect.x + radius);
+                hi = std::max(hi, rect.x + rect.w - radius - 1);
+            }
+        };
+
+        const int lastRow = rect.y + rect.h - 1;
+        for (int row = rect.y; row <= lastRow;) {
+            int lo = 0, hi = 0;
+            rowExtent(row, lo, hi);
+
+            int end = row + 1;
+            int nextLo = 0, nextHi = 0;
+            while (end <= lastRow) {
+                rowExtent(end, nextLo, nextHi);
+                if (nextLo != lo || nextHi != hi) {
+                    break;
+                }
+                end++;
+            }
+
+            batch.addRect(lo, row, hi - lo + 1, end - row, sdlColor);
+            row = end;
+        }
+
+        // When h == 2 * radius the corner discs poke one row past the
+        // rectangle, where there is no band joining the left and right sides
+        auto overflowRow = [&](int row, int center) {
+            if (std::abs(row - center) > radius) {
+                return;
+            }
+            const int halfWidth = corner.halfWidth(row - center);
+            if (rightCenter - leftCenter <= 2 * halfWidth + 1) {
+                const int lo = std::min(leftCenter, rightCenter) - halfWidth;
+                const int hi = std::max(leftCenter, rightCenter) + halfWidth;
+                batch.addRect(lo, row, hi - lo + 1, 1, sdlColor);
+            } else {
+                batch.addRect(leftCenter - halfWidth, row, 2 * halfWidth + 1, 1, sdlColor);
+                batch.addRect(rightCenter - halfWidth, row, 2 * halfWidth + 1, 1, sdlColor);
+            }
+        };
+        overflowRow(rect.y - 1, bottomCenter);
+        overflowRow(rect.y + rect.h, topCenter);
     } else {
-        // Draw outline only - use SDL for clean lines
+        // Draw outline only
         for (int i = 0; i < 2; ++i) {
             // Top line
-            SDL_RenderDrawLine(sdlRenderer, rect.x + radius, rect.y + i, rect.x + rect.w - radius, rect.y + i);
+            addLine(rect.x + radius, rect.y + i, rect.x + rect.w - radius, rect.y + i, 1, sdlColor);
             // Bottom line
-            SDL_RenderDrawLine(sdlRenderer, rect.x + radius, rect.y + rect.h - i, rect.x + rect.w - radius, rect.y + rect.h - i);
+            addLine(rect.x + radius, rect.y + rect.h - i, rect.x + rect.w - radius, rect.y + rect.h - i, 1, sdlColor);
             // Left line
-            SDL_RenderDrawLine(sdlRenderer, rect.x + i, rect.y + radius, rect.x + i, rect.y + rect.h - radius);
+            addLine(rect.x + i, rect.y + radius, rect.x + i, rect.y + rect.h - radius, 1, sdlColor);
             // Right line
-            SDL_RenderDrawLine(sdlRenderer, rect.x + rect.w - i, rect.y + radius, rect.x + rect.w - i, rect.y + rect.h - radius);
+            addLine(rect.x + rect.w - i, rect.y + radius, rect.x + rect.w - i, rect.y + rect.h - radius, 1, sdlColor);
         }
         
         // Corner arcs using circle outline
@@ -214,7 +721,15 @@ void Renderer::drawRoundedRect(const Rect& rect, const Color& color, int radius,
 }
 
 void Renderer::drawShadow(const Rect& rect, int offset, int blur) {
-    // Draw soft, realistic shadow with Gaussian-like falloff
+    // Real Gaussian blur, baked once per blur amount and nine-sliced
+    const ShadowCache::Shadow* shadow = shadowCache.get(SHADOW_CORNER_RADIUS, blur);
+    if (shadow) {
+        drawNineSlice(*shadow, Rect(rect.x + offset - shadow->spread, rect.y + offset - shadow->spread,
+                                    rect.w + 2 * shadow->spread, rect.h + 2 * shadow->spread));
+        return;
+    }
+
+    // Fallback: soft shadow with Gaussian-like falloff from stacked layers
     int steps = blur;
     if (steps < 4) steps = 4;
     if (steps > 20) steps = 20;
@@ -239,70 +754,96 @@ void Renderer::drawShadow(const Rect& rect, int offset, int blur) {
     }
 }
 
+void Renderer::drawNineSlice(const ShadowCache::Shadow& shadow, const Rect& dest) {
+    // Corners keep their texel size unless the destination is too small
+    const int cornerW = std::min(shadow.corner, dest.w / 2);
+    const int cornerH = std::min(shadow.corner, dest.h / 2);
+
+    const int srcEdges[4] = { 0, shadow.corner, shadow.corner + 1, shadow.size };
+    const int destX[4] = { dest.x, dest.x + cornerW, dest.x + dest.w - cornerW, dest.x + dest.w };
+    const int destY[4] = { dest.y, dest.y + cornerH, dest.y + dest.h - cornerH, dest.y + dest.h };
+    const float invSize = 1.0f / (float)shadow.size;
+    const SDL_Color white = toSDLColor(Color::White());
+
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            const int w = destX[col + 1] - destX[col];
+            const int h = destY[row + 1] - destY[row];
+            if (w <= 0 || h <= 0) {
+                continue;
+            }
+
+            const SDL_FRect target = { (float)destX[col], (float)destY[row], (float)w, (float)h };
+            const SDL_FRect uv = {
+                srcEdges[col] * invSize, srcEdges[row] * invSize,
+                (srcEdges[col + 1] - srcEdges[col]) * invSize, (srcEdges[row + 1] - srcEdges[row]) * invSize
+            };
+            batch.addTexturedRect(shadow.texture, target, uv, white);
+        }
+    }
+}
+
 void Renderer::drawCircle(int centerX, int centerY, int radius, const Color& color, bool filled) {
-    SDL_SetRenderDrawColor(sdlRenderer, color.r, color.g, color.b, color.a);
-    
-    // Midpoint circle algorithm
-    int x = radius;
-    int y = 0;
-    int radiusError = 1 - x;
+    const SDL_Color sdlColor = toSDLColor(color);
+    const CircleCache::Table& table = circleCache.get(radius);
     
-    while (x >= y) {
-        if (filled) {
-            // Draw horizontal lines to fill the circle
-            SDL_RenderDrawLine(sdlRenderer, centerX - x, centerY + y, centerX + x, centerY + y);
-            SDL_RenderDrawLine(sdlRenderer, centerX - x, centerY - y, centerX + x, centerY - y);
-            SDL_RenderDrawLine(sdlRenderer, centerX - y, centerY + x, centerX + y, centerY + x);
-            SDL_RenderDrawLine(sdlRenderer, centerX - y, centerY - x, centerX + y, centerY - x);
-        } else {
-            // Draw outline points
-            SDL_RenderDrawPoint(sdlRenderer, centerX + x, centerY + y);
-            SDL_RenderDrawPoint(sdlRenderer, centerX - x, centerY + y);
-            SDL_RenderDrawPoint(sdlRenderer, centerX + x, centerY - y);
-            SDL_RenderDrawPoint(sdlRenderer, centerX - x, centerY - y);
-            SDL_RenderDrawPoint(sdlRenderer, centerX + y, centerY + x);
-            SDL_RenderDrawPoint(sdlRenderer, centerX - y, centerY + x);
-            SDL_RenderDrawPoint(sdlRenderer, centerX + y, centerY - x);
-            SDL_RenderDrawPoint(sdlRenderer, centerX - y, centerY - x);
+    if (filled) {
+        // Merged horizontal spans, one quad each
+        for (const SDL_Rect& span : table.fill) {
+            batch.addRect(centerX + span.x, centerY + span.y, span.w, span.h, sdlColor);
         }
-        
-        y++;
-        if (radiusError < 0) {
-            radiusError += 2 * y + 1;
-        } else {
-            x--;
-            radiusError += 2 * (y - x + 1);
+    } else {
+        // Outline pixels, one small quad each (stays in the same batch)
+        for (const SDL_Point& point : table.outline) {
+            batch.addRect(centerX + point.x, centerY + point.y, 1, 1, sdlColor);
         }
     }
 }
 
 void Renderer::drawLine(int x1, int y1, int x2, int y2, const Color& color, int thickness) {
-    SDL_SetRenderDrawColor(sdlRenderer, color.r, color.g, color.b, color.a);
-    
     if (thickness <= 1) {
-        SDL_RenderDrawLine(sdlRenderer, x1, y1, x2, y2);
+        addLine(x1, y1, x2, y2, 1, toSDLColor(color));
     } else {
-        // Draw thick line by drawing multiple parallel lines
-        int halfThick = thickness / 2;
-        
-        // Calculate perpendicular offset based on line direction
-        float dx = (float)(x2 - x1);
-        float dy = (float)(y2 - y1);
-        float length = sqrtf(dx * dx + dy * dy);
-        
-        if (length > 0) {
-            float perpX = -dy / length;
-            float perpY = dx / length;
-            
-            for (int i = -halfThick; i <= halfThick; ++i) {
-                int offsetX = (int)(perpX * i);
-                int offsetY = (int)(perpY * i);
-                SDL_RenderDrawLine(sdlRenderer, 
-                    x1 + offsetX, y1 + offsetY, 
-                    x2 + offsetX, y2 + offsetY);
-            }
-        }
+        // Thick lines used to be 2 * (thickness / 2) + 1 parallel lines; keep that width
+        addLine(x1, y1, x2, y2, 2 * (thickness / 2) + 1, toSDLColor(color));
+    }
+}
+
+void Renderer::addLine(int x1, int y1, int x2, int y2, int width, const SDL_Color& color) {
+    const int half = width / 2;
+
+    // Axis-aligned lines cover whole pixels, endpoints inclusive
+    if (y1 == y2) {
+        batch.addRect(std::min(x1, x2), y1 - half, std::abs(x2 - x1) + 1, width, color);
+        return;
+    }
+    if (x1 == x2) {
+        batch.addRect(x1 - half, std::min(y1, y2), width, std::abs(y2 - y1) + 1, color);
+        return;
     }
+
+    // Diagonal: a quad around the segment between pixel centers, extended
+    // half a pixel past each endpoint like a rasterized line would be
+    const float dx = (float)(x2 - x1);
+    const float dy = (float)(y2 - y1);
+    const float length = sqrtf(dx * dx + dy * dy);
+    const float ux = dx / length * 0.5f;
+    const float uy = dy / length * 0.5f;
+    const float nx = -uy * width;
+    const float ny = ux * width;
+
+    const float sx = x1 + 0.5f - ux;
+    const float sy = y1 + 0.5f - uy;
+    const float ex = x2 + 0.5f + ux;
+    const float ey = y2 + 0.5f + uy;
+
+    const SDL_FPoint corners[4] = {
+        { sx + nx, sy + ny },
+        { ex + nx, ey + ny },
+        { ex - nx, ey - ny },
+        { sx - nx, sy - ny }
+    };
+    batch.addQuad(corners, color);
 }
 
 void Renderer::drawGlassCard(const Rect& rect, int radius, float opacity) {
@@ -323,6 +864,19 @@ void Renderer::drawGlassCard(const Rect& rect, int radius, float opacity) {
 }
 
 void Renderer::drawRadialGradient(int centerX, int centerY, int radius, const Color& centerColor, const Color& edgeColor) {
+    if (radius < 0) {
+        return;
+    }
+
+    // Nested discs are baked once per (colors, radius) and copied as one quad
+    SDL_Texture* texture = gradientCache.getRadial(centerColor, edgeColor, radius, getDrawBlendMode(), circleCache);
+    if (texture) {
+        const float size = (float)(2 * radius + 1);
+        const SDL_FRect dest = { (float)(centerX - radius), (float)(centerY - radius), size, size };
+        batch.addTexturedRect(texture, dest, { 0.0f, 0.0f, 1.0f, 1.0f }, toSDLColor(Color::White()));
+        return;
+    }
+
     // Draw concentric circles with color interpolation
     int steps = radius / 2;
     if (steps < 10) steps = 10;
@@ -341,4 +895,10 @@ void Renderer::drawRadialGradient(int centerX, int centerY, int radius, const Co
     }
 }
 
+SDL_BlendMode Renderer::getDrawBlendMode() const {
+    SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(sdlRenderer, &mode);
+    return mode;
+}
+
 } // namespace AOS
@@ -4,9 +4,18 @@
 #include <SDL2/SDL_ttf.h>
 #include <string>
 #include <map>
+#include <memory>
+#include <vector>
+#include "circle_cache.h"
+#include "draw_batch.h"
+#include "gradient_cache.h"
+#include "shadow_cache.h"
+#include "text_cache.h"
 
 namespace AOS {
 
+class GlyphAtlas;
+
 /**
  * Color structure
  */
@@ -16,6 +25,12 @@ struct Color {
     Color(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = 255)
         : r(red), g(green), b(blue), a(alpha) {}
 
+    // Packed 0xRRGGBBAA, handy as a cache key
+    uint32_t toRGBA() const {
+        return (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16) |
+               (static_cast<uint32_t>(b) << 8) | a;
+    }
+
     static Color Black() { return Color(0, 0, 0); }
     static Color White() { return Color(255, 255, 255); }
     static Color Red() { return Color(255, 0, 0); }
@@ -34,10 +49,21 @@ struct Rect {
         : x(xPos), y(yPos), w(width), h(height) {}
 };
 
+/**
+ * Renderer work counters (see Renderer::getCounters)
+ */
+struct RenderCounters {
+    uint64_t drawCalls;            // SDL_RenderGeometry / SDL_RenderCopy submissions
+    uint64_t textureCreations;
+    uint64_t textRasterizations;   // Whole strings plus glyphs added to atlases
+};
+
 /**
  * Renderer - Abstraction over SDL2 rendering
  *
  * Provides simple drawing primitives for apps.
+ * Primitives are batched into triangles and submitted with
+ * SDL_RenderGeometry when the texture changes or the frame is presented.
  * On desktop: renders to SDL window
  * On Pi: renders to framebuffer via SDL
  *
@@ -45,6 +71,7 @@ struct Rect {
  */
 class Renderer {
 public:
+    // window may be nullptr (headless); the size then comes from the renderer
     Renderer(SDL_Window* window, SDL_Renderer* sdlRenderer);
     ~Renderer();
 
@@ -52,6 +79,68 @@ public:
     void clear(const Color& color = Color::Black());
     void present();
 
+    // Submit queued primitives now (done automatically before direct SDL use)
+    void flush();
+
+    // Work done since the last resetCounters() (the profiler resets per frame)
+    RenderCounters getCounters() const;
+    void resetCounters();
+
+    // Write the frame drawn so far to a BMP file. Call before present():
+    // the back buffer is undefined afterwards.
+    bool saveFrame(const std::string& path);
+
+    // Retained frame: an offscreen texture that survives present(), so a
+    // later frame can repaint only the regions that changed. Returns false
+    // if render targets are unavailable.
+    bool setRetainedFrame(bool enabled);
+    bool hasRetainedFrame() const { return retainedFrame != nullptr; }
+
+    // Where the next frame is drawn: into the retained frame (copied to
+    // the window by present()) or straight to the window, which saves
+    // that full-screen copy for frames that are redrawn in full anyway
+    // but leaves the retained frame out of date.
+    void beginFrame(bool useRetainedFrame);
+    bool isRetainedFrameCurrent() const { return retainedFrameCurrent; }
+
+    // The window or output changed size: pick up the new size and
+    // rebuild the retained frame to match
+    void handleResize();
+
+    // Restrict drawing to a rectangle (clear() still fills everything).
+    // setClipRect() replaces the whole clip stack; clearClipRect() empties it.
+    void setClipRect(const Rect& rect);
+    void clearClipRect();
+
+    // Clip stack: each push intersects with the current clip
+    void pushClipRect(const Rect& rect);
+    void popClipRect();
+
+    // Transform stack. Transforms are integer translations: every
+    // primitive lands on whole pixels, so that is all that's needed.
+    void pushTranslate(int dx, int dy);
+    void popTranslate();
+
+    // Offscreen layers (see SceneNode). Between beginLayer() and
+    // endLayer() everything draws into the layer texture, with
+    // (originX, originY) in current coordinates at its top-left corner.
+    // Layers nest; transforms and clips are restored by endLayer().
+    SDL_Texture* createLayer(int width, int height);
+    void destroyLayer(SDL_Texture* layer);
+    bool beginLayer(SDL_Texture* layer, int originX, int originY);
+    void endLayer();
+
+    // Composite a layer. Opaque layers (content covers every texel) are
+    // copied; the rest are blended as premultiplied alpha.
+    void drawLayer(SDL_Texture* layer, const Rect& dest, bool opaque);
+
+    struct LayerStats {
+        uint64_t redraws;      // beginLayer() calls
+        uint64_t composites;   // drawLayer() calls
+    };
+
+    const LayerStats& getLayerStats() const { return layerStats; }
+
     // Drawing primitives
     void drawRect(const Rect& rect, const Color& color, bool filled = false);
     void drawText(const std::string& text, int x, int y, const Color& color, int fontSize = 24);
@@ -69,12 +158,20 @@ public:
     bool loadFont(const std::string& path, int size);
     TTF_Font* getFont(int size);
 
+    // Rendered-string cache for font sizes without a glyph atlas
+    void setTextCacheBudget(size_t bytes) { textCache.setBudget(bytes); }
+    const TextCache::Stats& getTextCacheStats() const { return textCache.getStats(); }
+
+    // Times a glyph atlas filled up and was wiped, over all font sizes
+    uint64_t getGlyphAtlasRebuilds() const;
+
     // Get screen dimensions
     int getWidth() const { return screenWidth; }
     int getHeight() const { return screenHeight; }
 
-    // Get SDL renderer (for advanced operations like screenshots)
-    SDL_Renderer* getSDLRenderer() { return sdlRenderer; }
+    // Get SDL renderer (for advanced operations like screenshots).
+    // Flushes queued primitives so direct SDL calls land on top of them.
+    SDL_Renderer* getSDLRenderer() { flush(); return sdlRenderer; }
 
 private:
     SDL_Window* window;
@@ -82,9 +179,64 @@ private:
     int screenWidth;
     int screenHeight;
 
+    // Offscreen copy of the screen, nullptr when drawing to the window
+    SDL_Texture* retainedFrame;
+    bool drawingToRetainedFrame;
+    bool retainedFrameCurrent;      // Holds the last presented frame
+
+    // Transform/clip stacks; the clip stack holds screen coordinates
+    int translateX;
+    int translateY;
+    std::vector<SDL_Point> translateStack;
+    std::vector<Rect> clipStack;
+
+    // State saved by beginLayer()
+    struct LayerState {
+        SDL_Texture* previousTarget;
+        int translateX;
+        int translateY;
+        std::vector<Rect> clipStack;
+    };
+
+    std::vector<LayerState> layerStack;
+    LayerStats layerStats;
+
+    // Work done by Renderer itself (cumulative); caches keep their own
+    RenderCounters ownCounters;
+    RenderCounters counterBaseline;
+
     // Font cache: size -> TTF_Font
     std::map<int, TTF_Font*> fontCache;
     std::string defaultFontPath;
+
+    // Primitives are queued here and submitted via SDL_RenderGeometry
+    DrawBatch batch;
+
+    // Midpoint-circle spans per radius (circles, rounded corners, shadows)
+    CircleCache circleCache;
+
+    // Baked linear/radial gradient textures
+    GradientCache gradientCache;
+
+    // Pre-blurred nine-slice drop shadows
+    ShadowCache shadowCache;
+
+    // Glyph atlases: size -> lazily filled glyph texture
+    std::map<int, std::unique_ptr<GlyphAtlas>> glyphAtlases;
+
+    // Whole-string textures for text that repeats across frames
+    TextCache textCache;
+    uint32_t frameIndex;
+
+    GlyphAtlas* getGlyphAtlas(int size);
+    void addLine(int x1, int y1, int x2, int y2, int width, const SDL_Color& color);
+    SDL_BlendMode getDrawBlendMode() const;
+    RenderCounters totalCounters() const;
+    void applyTranslate();
+    void applyClip();
+    void drawNineSlice(const ShadowCache::Shadow& shadow, const Rect& dest);
+    SDL_Texture* rasterizeText(TTF_Font* font, const std::string& text, const Color& color,
+                               int& width, int& height);
 };
 
 } // namespace AOS
@@ -0,0 +1,175 @@
+#include "scene_graph.h"
+#include "os/tracer.h"
+
+namespace AOS {
+
+SceneNode::SceneNode()
+    : parent(nullptr)
+    , x(0)
+    , y(0)
+    , bounds(0, 0, 0, 0)
+    , visible(true)
+    , clipToBounds(false)
+    , cacheable(false)
+    , opaque(false)
+    , layer(nullptr)
+    , layerWidth(0)
+    , layerHeight(0)
+    , dirty(true)
+{
+}
+
+SceneNode::SceneNode(DrawFunc draw)
+    : SceneNode()
+{
+    drawFunc = std::move(draw);
+}
+
+SceneNode::~SceneNode() {
+    if (layer) {
+        SDL_DestroyTexture(layer);
+    }
+}
+
+SceneNode* SceneNode::addChild(std::unique_ptr<SceneNode> child) {
+    child->parent = this;
+    children.push_back(std::move(child));
+    invalidate();
+    return children.back().get();
+}
+
+SceneNode* SceneNode::addChild(DrawFunc draw) {
+    return addChild(std::make_unique<SceneNode>(std::move(draw)));
+}
+
+void SceneNode::clearChildren() {
+    children.clear();
+    invalidate();
+}
+
+void SceneNode::setDrawFunc(DrawFunc draw) {
+    drawFunc = std::move(draw);
+    invalidate();
+}
+
+void SceneNode::setPosition(int newX, int newY) {
+    if (newX == x && newY == y) {
+        return;
+    }
+
+    // Our own layer is unaffected; a cached parent has us baked in
+    x = newX;
+    y = newY;
+    invalidateAncestors();
+}
+
+void SceneNode::setBounds(const Rect& localBounds) {
+    bounds = localBounds;
+    invalidate();
+}
+
+void SceneNode::setVisible(bool isVisible) {
+    if (isVisible == visible) {
+        return;
+    }
+
+    visible = isVisible;
+    invalidateAncestors();
+}
+
+void SceneNode::setClipToBounds(bool clip) {
+    clipToBounds = clip;
+    invalidate();
+}
+
+void SceneNode::setCacheable(bool isCacheable, bool isOpaque) {
+    cacheable = isCacheable;
+    opaque = isOpaque;
+    invalidate();
+}
+
+void SceneNode::invalidate() {
+    dirty = true;
+    invalidateAncestors();
+}
+
+void SceneNode::releaseLayers() {
+    if (layer) {
+        SDL_DestroyTexture(layer);
+        layer = nullptr;
+        layerWidth = 0;
+        layerHeight = 0;
+    }
+    dirty = true;
+
+    for (auto& child : children) {
+        child->releaseLayers();
+    }
+}
+
+void SceneNode::render(Renderer& renderer) {
+    if (!visible) {
+        return;
+    }
+
+    renderer.pushTranslate(x, y);
+
+    if (cacheable && bounds.w > 0 && bounds.h > 0) {
+        if (layer && (layerWidth != bounds.w || layerHeight != bounds.h)) {
+            renderer.destroyLayer(layer);
+            layer = nullptr;
+        }
+        if (!layer) {
+            layer = renderer.createLayer(bounds.w, bounds.h);
+            layerWidth = bounds.w;
+            layerHeight = bounds.h;
+            dirty = true;
+        }
+    }
+
+    if (!layer || !cacheable) {
+        // Not cached (or no render targets): draw straight through
+        renderContent(renderer);
+    } else {
+        if (dirty && renderer.beginLayer(layer, bounds.x, bounds.y)) {
+            AOS_TRACE_ZONE("SceneNode layer redraw", "render");
+            renderContent(renderer);
+            renderer.endLayer();
+            dirty = false;
+        }
+
+        if (dirty) {
+            renderContent(renderer);  // beginLayer failed
+        } else {
+            renderer.drawLayer(layer, bounds, opaque);
+        }
+    }
+
+    renderer.popTranslate();
+}
+
+void SceneNode::invalidateAncestors() {
+    for (SceneNode* node = parent; node; node = node->parent) {
+        node->dirty = true;
+    }
+}
+
+void SceneNode::renderContent(Renderer& renderer) {
+    if (clipToBounds) {
+        renderer.pushClipRect(bounds);
+    }
+
+    if (drawFunc) {
+        drawFunc(renderer);
+    }
+
+    for (auto& child : children) {
+        child->render(renderer);
+    }
+
+    if (clipToBounds) {
+        renderer.popClipRect();
+    }
+}
+
+} // namespace AOS
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "renderer.h"
+
+namespace AOS {
+
+/**
+ * SceneNode - Retained-mode drawing on top of Renderer
+ *
+ * A tree of nodes, each with a position relative to its parent, local
+ * bounds and an optional draw callback. render() walks the tree
+ * depth-first: a node's own content first, then its children in order,
+ * all translated by the node's position.
+ *
+ * A cacheable node renders its subtree once into a render-target texture
+ * (a layer covering its bounds) and afterwards only composites that
+ * texture, until invalidate() is called on it or on a node below it.
+ * Moving a cached node does not redraw it. Mark a layer opaque when its
+ * content covers the whole bounds; it is then copied without blending.
+ *
+ * Layers are SDL textures: call releaseLayers() when the scene goes
+ * offscreen and before the Renderer is destroyed, outside of render().
+ */
+class SceneNode {
+public:
+    using DrawFunc = std::function<void(Renderer&)>;
+
+    SceneNode();
+    explicit SceneNode(DrawFunc draw);
+    ~SceneNode();
+
+    // Non-copyable (owns an SDL texture)
+    SceneNode(const SceneNode&) = delete;
+    SceneNode& operator=(const SceneNode&) = delete;
+
+    // Children are owned by the node and drawn in insertion order
+    SceneNode* addChild(std::unique_ptr<SceneNode> child);
+    SceneNode* addChild(DrawFunc draw);
+    void clearChildren();
+
+    void setDrawFunc(DrawFunc draw);
+    void setPosition(int x, int y);
+    void setBounds(const Rect& localBounds);
+    void setVisible(bool visible);
+    void setClipToBounds(bool clip);
+    void setCacheable(bool cacheable, bool opaque = false);
+
+    int getX() const { return x; }
+    int getY() const { return y; }
+    const Rect& getBounds() const { return bounds; }
+    bool isVisible() const { return visible; }
+
+    // Content changed: redraw this node's layer and any cached ancestor
+    void invalidate();
+
+    // Destroy the layer textures of this subtree (they are recreated on
+    // the next render)
+    void releaseLayers();
+
+    void render(Renderer& renderer);
+
+private:
+    SceneNode* parent;
+    std::vector<std::unique_ptr<SceneNode>> children;
+    DrawFunc drawFunc;
+
+    int x;
+    int y;
+    Rect bounds;
+    bool visible;
+    bool clipToBounds;
+    bool cacheable;
+    bool opaque;
+
+    // Cached layer
+    SDL_Texture* layer;
+    int layerWidth;
+    int layerHeight;
+    bool dirty;
+
+    void invalidateAncestors();
+    void renderContent(Renderer& renderer);
+};
+
+} // namespace AOS
@@ -0,0 +1,168 @@
+#include "shadow_cache.h"
+#include "os/tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace AOS {
+
+namespace {
+
+// Peak opacity of the shadow, about what the stacked layers reached at
+// their center when blended
+constexpr float SHADOW_OPACITY = 140.0f;
+
+// Coverage of a pixel centered at (px, py) by a rounded box, anti-aliased
+// over one pixel using the box's signed distance
+float roundedBoxCoverage(float px, float py, float center, float halfExtent, float radius) {
+    const float qx = std::fabs(px - center) - (halfExtent - radius);
+    const float qy = std::fabs(py - center) - (halfExtent - radius);
+    const float outside = std::sqrt(std::max(qx, 0.0f) * std::max(qx, 0.0f) +
+                                    std::max(qy, 0.0f) * std::max(qy, 0.0f));
+    const float inside = std::min(std::max(qx, qy), 0.0f);
+    const float distance = outside + inside - radius;
+    return std::min(std::max(0.5f - distance, 0.0f), 1.0f);
+}
+
+// One pass of a separable Gaussian blur along rows or columns
+void blurPass(const std::vector<float>& src, std::vector<float>& dst, int size,
+              const std::vector<float>& kernel, bool horizontal) {
+    const int reach = static_cast<int>(kernel.size()) / 2;
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float sum = 0.0f;
+            for (int k = -reach; k <= reach; ++k) {
+                const int sx = horizontal ? x + k : x;
+                const int sy = horizontal ? y : y + k;
+                if (sx < 0 || sy < 0 || sx >= size || sy >= size) {
+                    continue;
+                }
+                sum += src[static_cast<size_t>(sy) * size + sx] * kernel[k + reach];
+            }
+            dst[static_cast<size_t>(y) * size + x] = sum;
+        }
+    }
+}
+
+} // namespace
+
+ShadowCache::ShadowCache(SDL_Renderer* sdlRend)
+    : sdlRenderer(sdlRend)
+    , frameIndex(0)
+    , texturesCreated(0)
+{
+}
+
+ShadowCache::~ShadowCache() {
+    clear();
+}
+
+const ShadowCache::Shadow* ShadowCache::get(int radius, int blur) {
+    radius = std::max(radius, 0);
+    blur = std::max(blur, 0);
+
+    const uint32_t key = (static_cast<uint32_t>(radius) << 16) | static_cast<uint32_t>(blur & 0xFFFF);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        it->second.lastUsedFrame = frameIndex;
+        return &it->second.shadow;
+    }
+
+    Shadow shadow = {};
+    if (!bake(radius, blur, shadow)) {
+        return nullptr;
+    }
+
+    Entry& entry = entries[key];
+    entry.shadow = shadow;
+    entry.lastUsedFrame = frameIndex;
+    return &entry.shadow;
+}
+
+void ShadowCache::endFrame() {
+    frameIndex++;
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (frameIndex - it->second.lastUsedFrame > EVICT_AFTER_FRAMES) {
+            SDL_DestroyTexture(it->second.shadow.texture);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ShadowCache::clear() {
+    for (auto& pair : entries) {
+        SDL_DestroyTexture(pair.second.shadow.texture);
+    }
+    entries.clear();
+}
+
+bool ShadowCache::bake(int radius, int blur, Shadow& shadow) {
+    AOS_TRACE_ZONE("ShadowCache::bake", "render");
+
+    // Gaussian with ~95% of its mass inside the blur distance
+    const int spread = blur;
+    const float sigma = std::max(blur * 0.5f, 0.5f);
+    const int reach = blur > 0 ? static_cast<int>(std::ceil(sigma * 3.0f)) : 0;
+
+    // The middle texel must sit where neither the corner rounding nor the
+    // blur reaches, otherwise stretching it would smear the falloff
+    const int corner = spread + radius + reach;
+    const int size = 2 * corner + 1;
+
+    std::vector<float> coverage(static_cast<size_t>(size) * size);
+    const float center = size * 0.5f;
+    const float halfExtent = center - spread;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            coverage[static_cast<size_t>(y) * size + x] =
+                roundedBoxCoverage(x + 0.5f, y + 0.5f, center, halfExtent, static_cast<float>(radius));
+        }
+    }
+
+    if (reach > 0) {
+        std::vector<float> kernel(2 * reach + 1);
+        float total = 0.0f;
+        for (int k = -reach; k <= reach; ++k) {
+            kernel[k + reach] = std::exp(-(k * k) / (2.0f * sigma * sigma));
+            total += kernel[k + reach];
+        }
+        for (float& weight : kernel) {
+            weight /= total;
+        }
+
+        std::vector<float> scratch(coverage.size());
+        blurPass(coverage, scratch, size, kernel, true);
+        blurPass(scratch, coverage, size, kernel, false);
+    }
+
+    std::vector<uint8_t> pixels(coverage.size() * 4, 0);
+    for (size_t i = 0; i < coverage.size(); ++i) {
+        pixels[i * 4 + 3] = static_cast<uint8_t>(coverage[i] * SHADOW_OPACITY + 0.5f);
+    }
+
+    SDL_Texture* texture = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_RGBA32,
+                                             SDL_TEXTUREACCESS_STATIC, size, size);
+    if (!texture) {
+        std::cerr << "ShadowCache: SDL_CreateTexture failed: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), size * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+
+    texturesCreated++;
+    shadow.texture = texture;
+    shadow.size = size;
+    shadow.corner = corner;
+    shadow.spread = spread;
+    return true;
+}
+
+} // namespace AOS
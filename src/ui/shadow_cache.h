@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <unordered_map>
+
+namespace AOS {
+
+/**
+ * ShadowCache - Pre-blurred nine-slice drop shadow textures
+ *
+ * A rounded rectangle is rasterized once per (corner radius, blur) and run
+ * through a separable Gaussian kernel. The texture is laid out so that its
+ * single middle row/column is fully inside the flat part of the shadow:
+ *
+ *   +--------+-+--------+
+ *   | corner |e| corner |    corner = blur + radius + blur kernel reach
+ *   +--------+-+--------+    e      = 1 texel, stretched to any size
+ *   |  edge  |c|  edge  |
+ *   +--------+-+--------+
+ *   | corner |e| corner |
+ *   +--------+-+--------+
+ *
+ * Any shadow size is then nine textured quads. The offset only moves the
+ * quads, so it is not part of the key.
+ */
+class ShadowCache {
+public:
+    static constexpr uint32_t EVICT_AFTER_FRAMES = 120;
+
+    struct Shadow {
+        SDL_Texture* texture;
+        int size;      // Texture is size x size
+        int corner;    // Width/height of each corner slice
+        int spread;    // How far the shadow extends past the shape
+    };
+
+    explicit ShadowCache(SDL_Renderer* sdlRenderer);
+    ~ShadowCache();
+
+    // Non-copyable (owns SDL textures)
+    ShadowCache(const ShadowCache&) = delete;
+    ShadowCache& operator=(const ShadowCache&) = delete;
+
+    // Get (baking on first use) the shadow for a corner radius and blur
+    // amount. Returns nullptr if the texture can't be created.
+    const Shadow* get(int radius, int blur);
+
+    // Advance the frame clock and evict stale entries
+    void endFrame();
+
+    // Destroy all textures
+    void clear();
+
+    size_t getEntryCount() const { return entries.size(); }
+    uint64_t getTexturesCreated() const { return texturesCreated; }
+
+private:
+    struct Entry {
+        Shadow shadow;
+        uint32_t lastUsedFrame;
+    };
+
+    SDL_Renderer* sdlRenderer;
+    std::unordered_map<uint32_t, Entry> entries;  // (radius << 16 | blur) -> shadow
+    uint32_t frameIndex;
+    uint64_t texturesCreated;
+
+    bool bake(int radius, int blur, Shadow& shadow);
+};
+
+} // namespace AOS
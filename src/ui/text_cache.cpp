@@ -0,0 +1,132 @@
+#include "text_cache.h"
+
+#include <iterator>
+
+#include "renderer.h"
+
+namespace AOS {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 1469598103934665603ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+} // namespace
+
+TextCache::TextCache(size_t budget)
+    : budgetBytes(budget)
+{
+}
+
+TextCache::~TextCache() {
+    clear();
+}
+
+uint64_t TextCache::makeKey(const std::string& text, int fontSize, const Color& color) {
+    // FNV-1a over the bytes, then fold in size and color
+    uint64_t hash = FNV_OFFSET;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(fontSize)) << 32) | color.toRGBA();
+    hash *= FNV_PRIME;
+    return hash;
+}
+
+const TextCache::Entry* TextCache::find(uint64_t key, const std::string& text,
+                                        int fontSize, const Color& color) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    // Verify the full key; a hash collision is just a miss
+    const Entry& entry = *it->second;
+    if (entry.fontSize != fontSize || entry.rgba != color.toRGBA() || entry.text != text) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    // Move to front (most recently used)
+    entries.splice(entries.begin(), entries, it->second);
+    stats.hits++;
+    return &entries.front();
+}
+
+bool TextCache::shouldAdmit(uint64_t key, uint32_t frameIndex) {
+    auto it = candidates.find(key);
+    if (it == candidates.end()) {
+        if (candidates.size() >= MAX_CANDIDATES) {
+            candidates.clear();
+        }
+        candidates.emplace(key, frameIndex);
+        return false;
+    }
+
+    if (it->second == frameIndex) {
+        return false;
+    }
+
+    candidates.erase(it);
+    return true;
+}
+
+const TextCache::Entry* TextCache::insert(uint64_t key, const std::string& text, int fontSize,
+                                          const Color& color, SDL_Texture* texture,
+                                          int width, int height) {
+    const size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    if (bytes > budgetBytes) {
+        return nullptr;
+    }
+
+    // Replace a colliding entry rather than keeping two under one key
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        erase(existing->second);
+    }
+
+    evictToBudget(budgetBytes - bytes);
+
+    entries.push_front({ key, text, fontSize, color.toRGBA(), texture, width, height, bytes });
+    index[key] = entries.begin();
+
+    stats.insertions++;
+    stats.bytesUsed += bytes;
+    stats.entryCount = entries.size();
+    return &entries.front();
+}
+
+void TextCache::setBudget(size_t budget) {
+    budgetBytes = budget;
+    evictToBudget(budgetBytes);
+}
+
+void TextCache::clear() {
+    for (auto& entry : entries) {
+        SDL_DestroyTexture(entry.texture);
+    }
+    entries.clear();
+    index.clear();
+    candidates.clear();
+    stats.bytesUsed = 0;
+    stats.entryCount = 0;
+}
+
+void TextCache::evictToBudget(size_t budget) {
+    while (!entries.empty() && stats.bytesUsed > budget) {
+        erase(std::prev(entries.end()));
+        stats.evictions++;
+    }
+}
+
+void TextCache::erase(EntryList::iterator it) {
+    SDL_DestroyTexture(it->texture);
+    stats.bytesUsed -= it->bytes;
+    index.erase(it->key);
+    entries.erase(it);
+    stats.entryCount = entries.size();
+}
+
+} // namespace AOS
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace AOS {
+
+struct Color;
+
+/**
+ * TextCache - Rendered-string textures kept across frames
+ *
+ * Keyed by (text, font size, color). Entries live in an LRU list and are
+ * evicted oldest-first once the texture bytes exceed the configured budget.
+ *
+ * Only used for font sizes that have no glyph atlas (the atlas texture
+ * could not be created); everything else is drawn as batched glyph quads.
+ * Strings are only admitted after they have been drawn on two different
+ * frames, so text that changes every frame (timers, counters) is
+ * rasterized per call instead of churning through cache entries.
+ */
+class TextCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 8 * 1024 * 1024;
+
+    struct Entry {
+        uint64_t key;
+        std::string text;
+        int fontSize;
+        Uint32 rgba;
+        SDL_Texture* texture;
+        int width;
+        int height;
+        size_t bytes;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t bytesUsed = 0;
+        size_t entryCount = 0;
+    };
+
+    explicit TextCache(size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+    ~TextCache();
+
+    // Non-copyable (owns SDL textures)
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    // Hash of (text, size, color); compute once and pass to find/admit/insert
+    static uint64_t makeKey(const std::string& text, int fontSize, const Color& color);
+
+    // Look up a cached string; marks it most recently used. Counts a hit or miss.
+    const Entry* find(uint64_t key, const std::string& text, int fontSize, const Color& color);
+
+    // Returns true when a missed string has now been seen on an earlier frame
+    bool shouldAdmit(uint64_t key, uint32_t frameIndex);
+
+    // Take ownership of a rendered texture. Returns nullptr (and destroys
+    // nothing) if the texture alone would exceed the budget.
+    const Entry* insert(uint64_t key, const std::string& text, int fontSize, const Color& color,
+                        SDL_Texture* texture, int width, int height);
+
+    // Change the byte budget, evicting as needed
+    void setBudget(size_t budgetBytes);
+    size_t getBudget() const { return budgetBytes; }
+
+    // Destroy all cached textures
+    void clear();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    using EntryList = std::list<Entry>;
+
+    static constexpr size_t MAX_CANDIDATES = 512;
+
+    size_t budgetBytes;
+    EntryList entries;                                      // Front = most recently used
+    std::unordered_map<uint64_t, EntryList::iterator> index;
+    std::unordered_map<uint64_t, uint32_t> candidates;      // key -> frame first seen
+    Stats stats;
+
+    void evictToBudget(size_t budget);
+    void erase(EntryList::iterator it);
+};
+
+} // namespace AOS